@@ -0,0 +1,75 @@
+#ifndef BENCH_H
+#define BENCH_H
+
+#include "../src/enemies.hpp"
+
+#include <array>
+#include <chrono>
+#include <iostream>
+#include <iomanip>
+#include <memory>
+#include <string>
+
+// tiny helpers shared by the headless benchmarks (no window, no GL context)
+namespace Bench
+{
+    using Clock = std::chrono::steady_clock;
+
+    // run fn once to warm up, then time `iterations` calls and return ns per call
+    template <typename F>
+    inline double timePerCall(const std::size_t iterations, F&& fn)
+    {
+        fn(0);
+        const Clock::time_point start {Clock::now()};
+        for (std::size_t i{0}; i < iterations; ++i)
+        {
+            fn(i);
+        }
+        const std::chrono::duration<double, std::nano> elapsed {Clock::now() - start};
+        return elapsed.count() / static_cast<double>(iterations);
+    }
+
+    inline void report(const std::string& name, const double value, const std::string& unit)
+    {
+        std::cout << "  " << std::left << std::setw(40) << name << std::right << std::setw(12) << std::fixed << std::setprecision(2) << value << ' ' << unit << '\n';
+    }
+
+    // heap allocations the bench binary has made so far (counted by the operator new in pool.cpp)
+    std::size_t allocationCount();
+
+    // record a failed check, the runner exits non-zero if there were any (defined in main.cpp)
+    void fail(const std::string& what);
+    std::size_t failureCount();
+
+    // data/maps/0.json without the loader's std::cout spam, which would swamp the timings (defined in fixtures.cpp)
+    std::unique_ptr<World> loadLevel();
+
+    // the enemy benches' setup: a player at the top middle of the level, the whole level as the camera so every
+    // enemy gets the full update, and empty pools of every type
+    struct EnemyScene
+    {
+        EnemyScene(const World* world, std::size_t capacity);
+
+        // count enemies of alternating types anywhere in the level, from a fixed seed
+        void spawn(const World* world, std::size_t count);
+        // the frame the EntityManager runs minus vfx and drawing
+        void frame(World* world, JobSystem* jobs = nullptr);
+
+        const std::array<EnemyKind, NUM_ENEMY_TYPES> kinds;
+        const AnimSet anims{};
+        FlowField flow{};
+        Player player;
+        Rectangle level;
+        std::array<EnemyPool, NUM_ENEMY_TYPES> pools;
+        EventQueue events{};
+    };
+
+    // stop the optimizer from throwing away benchmark results
+    template <typename T>
+    inline void keep(const T& value)
+    {
+        asm volatile("" : : "g"(&value) : "memory");
+    }
+}
+
+#endif
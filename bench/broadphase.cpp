@@ -0,0 +1,89 @@
+#include "bench.hpp"
+
+#include "../src/spatialgrid.hpp"
+
+#include <vector>
+#include <random>
+#include <string>
+#include <cmath>
+
+void benchBroadphase()
+{
+    // enemy sized boxes over a level sized area, bullets flying in every direction
+    constexpr float width {1344.f};
+    constexpr float height {864.f};
+    constexpr float halfLength {4.f};
+    constexpr float bulletRange {8.f};
+    std::mt19937 rng{1234};
+    std::uniform_real_distribution<float> distX{0.f, width};
+    std::uniform_real_distribution<float> distY{0.f, height};
+    std::uniform_real_distribution<float> distAngle{0.f, 6.2831853f};
+
+    struct TestBullet
+    {
+        float x, y, angle;
+    };
+
+    SpatialGrid grid{};
+    for (const std::size_t enemies : {std::size_t{100}, std::size_t{10'000}})
+    {
+        std::vector<Rectangle> rects(enemies);
+        for (Rectangle& rect : rects)
+        {
+            rect = {distX(rng), distY(rng), 6.f, 7.f};
+        }
+        std::vector<TestBullet> bullets(256);
+        for (TestBullet& bullet : bullets)
+        {
+            bullet = {distX(rng), distY(rng), distAngle(rng)};
+        }
+
+        // what EntityManager::update used to do, every bullet against every enemy
+        std::size_t bruteHits {0};
+        const double brute {Bench::timePerCall(20, [&](const std::size_t) {
+            bruteHits = 0;
+            for (const Rectangle& rect : rects)
+            {
+                for (const TestBullet& bullet : bullets)
+                {
+                    if (CheckCollisionRecs({
+                        bullet.x + std::cos(bullet.angle) * halfLength - bulletRange * 0.5f,
+                        bullet.y + std::sin(bullet.angle) * halfLength - bulletRange * 0.5f,
+                        bulletRange, bulletRange}, rect))
+                    {
+                        ++bruteHits;
+                    }
+                }
+            }
+            Bench::keep(bruteHits);
+        })};
+
+        std::size_t gridHits {0};
+        const double grided {Bench::timePerCall(200, [&](const std::size_t) {
+            grid.reset(width, height);
+            for (std::size_t i{0}; i < rects.size(); ++i)
+            {
+                grid.add(rects[i], static_cast<std::uint32_t>(i));
+            }
+            grid.build();
+            gridHits = 0;
+            for (const TestBullet& bullet : bullets)
+            {
+                const float tipX {bullet.x + std::cos(bullet.angle) * halfLength};
+                const float tipY {bullet.y + std::sin(bullet.angle) * halfLength};
+                grid.query({tipX - bulletRange * 0.5f, tipY - bulletRange * 0.5f, bulletRange, bulletRange}, [&](const std::uint32_t) {
+                    ++gridHits;
+                });
+            }
+            Bench::keep(gridHits);
+        })};
+
+        if (gridHits != bruteHits)
+        {
+            std::cout << "  grid found " << gridHits << " hits, brute force found " << bruteHits << "!\n";
+        }
+        const std::string name {std::to_string(enemies) + " enemies x " + std::to_string(bullets.size()) + " bullets"};
+        Bench::report("brute force, " + name, brute / 1000.0, "us");
+        Bench::report("grid build + query, " + name, grided / 1000.0, "us");
+    }
+}
@@ -0,0 +1,28 @@
+#include "bench.hpp"
+
+#include <algorithm>
+#include <string>
+
+void benchEnemies()
+{
+    const std::unique_ptr<World> world {Bench::loadLevel()};
+
+    // half blobbos, half penguins dropped all over the level
+    for (const bool chasing : {false, true})
+    {
+        constexpr std::size_t count {10'000};
+        Bench::EnemyScene scene {world.get(), count};
+        scene.spawn(world.get(), count);
+        for (EnemyPool& pool : scene.pools)
+        {
+            std::fill(pool.wandering.begin(), pool.wandering.end(), !chasing);
+        }
+
+        const double frame {Bench::timePerCall(600, [&](const std::size_t) {
+            scene.frame(world.get());
+        })};
+        const std::string name {std::to_string(count) + (chasing ? " chasing" : " wandering")};
+        Bench::report("enemy frame, " + name, frame / 1'000'000.0, "ms");
+        Bench::report("enemy update, " + name, frame / static_cast<double>(count), "ns/enemy");
+    }
+}
@@ -0,0 +1,44 @@
+#include "bench.hpp"
+
+#include <cstdlib>
+#include <random>
+
+std::unique_ptr<World> Bench::loadLevel()
+{
+    std::unique_ptr<World> world {std::make_unique<World>()};
+    std::streambuf* out {std::cout.rdbuf(nullptr)};
+    world->loadFromFile("data/maps/0.json");
+    std::cout.rdbuf(out);
+    return world;
+}
+
+Bench::EnemyScene::EnemyScene(const World* world, const std::size_t capacity)
+ : kinds{Enemies::makeKinds()},
+   player{{world->getPixelWidth() * 0.5f, 0.f}, {7, 14}},
+   level{0.f, 0.f, world->getPixelWidth(), world->getPixelHeight()},
+   pools{EnemyPool{EnemyType::BLOBBO, capacity}, EnemyPool{EnemyType::PENGUIN, capacity}}
+{
+}
+
+void Bench::EnemyScene::spawn(const World* world, const std::size_t count)
+{
+    // add seeds every enemy's own random stream from std::rand
+    std::srand(1234);
+    std::mt19937 rng{1234};
+    std::uniform_real_distribution<float> distX{0.f, world->getPixelWidth()};
+    std::uniform_real_distribution<float> distY{0.f, world->getPixelHeight()};
+    for (std::size_t i{0}; i < count; ++i)
+    {
+        pools[i % NUM_ENEMY_TYPES].add(kinds[i % NUM_ENEMY_TYPES], {distX(rng), distY(rng)});
+    }
+}
+
+void Bench::EnemyScene::frame(World* world, JobSystem* jobs)
+{
+    flow.update(world, player.getRect());
+    for (std::size_t type{0}; type < NUM_ENEMY_TYPES; ++type)
+    {
+        Enemies::update(pools[type], anims, 1.f, world, &player, &flow, level, events, jobs);
+    }
+    events.dispatch();
+}
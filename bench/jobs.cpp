@@ -0,0 +1,88 @@
+#include "bench.hpp"
+
+#include "../src/jobs.hpp"
+
+#include <algorithm>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace
+{
+    // fnv-1a over every enemy's state, equal hashes mean the runs agree bit for bit
+    std::uint64_t hashScene(const Bench::EnemyScene& scene)
+    {
+        std::uint64_t hash {14695981039346656037ull};
+        const auto mix {[&hash](const void* data, const std::size_t size) {
+            const unsigned char* bytes {static_cast<const unsigned char*>(data)};
+            for (std::size_t i{0}; i < size; ++i)
+            {
+                hash = (hash ^ bytes[i]) * 1099511628211ull;
+            }
+        }};
+        for (const EnemyPool& pool : scene.pools)
+        {
+            for (std::size_t i{0}; i < pool.size(); ++i)
+            {
+                mix(&pool.bodies[i].pos, sizeof(vec2<float>));
+                mix(&pool.bodies[i].vel, sizeof(vec2<float>));
+                mix(&pool.anims[i].frame, sizeof(float));
+                mix(&pool.falling[i], sizeof(float));
+                mix(&pool.rng[i], sizeof(std::uint32_t));
+            }
+        }
+        const float health {scene.player.getHealth()};
+        mix(&health, sizeof(float));
+        return hash;
+    }
+}
+
+void benchJobs()
+{
+    const std::unique_ptr<World> world {Bench::loadLevel()};
+    // every enemy in the level chasing, a late wave
+    constexpr std::size_t count {50'000};
+    constexpr std::size_t frames {200};
+    const auto makeScene {[&]() {
+        std::unique_ptr<Bench::EnemyScene> scene {std::make_unique<Bench::EnemyScene>(world.get(), count)};
+        scene->spawn(world.get(), count);
+        for (EnemyPool& pool : scene->pools)
+        {
+            std::fill(pool.wandering.begin(), pool.wandering.end(), false);
+        }
+        return scene;
+    }};
+
+    // reference run on this thread only
+    std::unique_ptr<Bench::EnemyScene> reference {makeScene()};
+    const double serial {Bench::timePerCall(frames, [&](const std::size_t) {reference->frame(world.get());})};
+    const std::uint64_t expected {hashScene(*reference)};
+    Bench::report("enemy frame, " + std::to_string(count) + " serial", serial / 1'000'000.0, "ms");
+
+    // always go up to a few workers so the determinism check sees stealing, even on a small machine
+    const std::size_t cores {std::max(1u, std::thread::hardware_concurrency())};
+    const std::size_t maxWorkers {std::max<std::size_t>(cores, 4)};
+    std::cout << "  (" << cores << " cores)\n";
+    // powers of two, then the core count itself when it isn't one
+    std::vector<std::size_t> workerCounts{};
+    for (std::size_t workers{1}; workers < maxWorkers; workers *= 2)
+    {
+        workerCounts.push_back(workers);
+    }
+    workerCounts.push_back(maxWorkers);
+
+    for (const std::size_t workers : workerCounts)
+    {
+        JobSystem jobs {workers};
+        std::unique_ptr<Bench::EnemyScene> scene {makeScene()};
+        const double time {Bench::timePerCall(frames, [&](const std::size_t) {scene->frame(world.get(), &jobs);})};
+        const std::string name {std::to_string(jobs.getWorkerCount()) + " workers"};
+        Bench::report("enemy frame, " + name, time / 1'000'000.0, "ms");
+        Bench::report("speedup, " + name, serial / time, "x");
+        if (hashScene(*scene) != expected)
+        {
+            Bench::fail(name + " doesn't match the serial run");
+        }
+    }
+}
@@ -0,0 +1,108 @@
+#include "bench.hpp"
+
+#include "../src/kernels.hpp"
+
+#include <cmath>
+#include <cstring>
+#include <random>
+#include <vector>
+
+namespace
+{
+    // every kernel on the same input at every level, the outputs have to match the scalar ones bit for bit.
+    // the count leaves a tail that isn't a multiple of 4 or 8
+    void checkLevels()
+    {
+        constexpr std::size_t count {1'000 + 5};
+        std::mt19937 rng{1234};
+        std::uniform_real_distribution<float> value{-100.f, 100.f};
+        std::vector<float> pos(count);
+        std::vector<float> vel(count);
+        std::vector<float> speed(count);
+        std::vector<float> life(count);
+        for (std::size_t i{0}; i < count; ++i)
+        {
+            pos[i] = value(rng);
+            vel[i] = value(rng);
+            speed[i] = value(rng);
+            // mostly alive, with a few dead ones scattered through the blocks and the tail
+            life[i] = i % 97 == 3 || i == count - 2 ? -value(rng) * value(rng) : 1.f + std::abs(value(rng));
+        }
+
+        const auto run {[&](const SimdLevel level) {
+            Kernels::setLevel(level);
+            std::vector<float> out {pos};
+            Kernels::integrate(out.data(), vel.data(), count, 0.37f);
+            Kernels::advance(out.data(), vel.data(), speed.data(), count, 0.61f);
+            Kernels::add(out.data(), count, 0.16f);
+            Kernels::scale(out.data(), count, 0.983f);
+            // every dead index, found from every start
+            for (std::size_t i {Kernels::findDead(life.data(), 0, count)}; i < count; i = Kernels::findDead(life.data(), i + 1, count))
+            {
+                out.push_back(static_cast<float>(i));
+            }
+            return out;
+        }};
+
+        const std::vector<float> expected {run(SimdLevel::SCALAR)};
+        for (int level{1}; level <= static_cast<int>(Kernels::getBestLevel()); ++level)
+        {
+            const std::vector<float> got {run(static_cast<SimdLevel>(level))};
+            if (got.size() != expected.size() || std::memcmp(got.data(), expected.data(), got.size() * sizeof(float)) != 0)
+            {
+                Bench::fail(std::string{Kernels::getLevelName(static_cast<SimdLevel>(level))} + " kernels don't match scalar");
+            }
+        }
+        Kernels::setLevel(Kernels::getBestLevel());
+    }
+}
+
+void benchKernels()
+{
+    checkLevels();
+
+    // one full pool's worth, the size the particle updates run them on
+    constexpr std::size_t count {16'384};
+    constexpr std::size_t calls {2'000};
+
+    std::vector<float> pos(count, 0.f);
+    std::vector<float> vel(count, 0.5f);
+    std::vector<float> speed(count, 2.f);
+    std::vector<float> life(count, 1000.f); // nobody dies, so the culling scan goes all the way through
+
+    const double perMicro {static_cast<double>(count) * 1'000.0};
+    const SimdLevel best {Kernels::getBestLevel()};
+    for (int level{0}; level <= static_cast<int>(best); ++level)
+    {
+        Kernels::setLevel(static_cast<SimdLevel>(level));
+        const std::string name {Kernels::getLevelName(Kernels::getLevel())};
+
+        const double integrate {Bench::timePerCall(calls, [&](const std::size_t) {
+            Kernels::integrate(pos.data(), vel.data(), count, 1.f);
+            Bench::keep(pos[0]);
+        })};
+        const double advance {Bench::timePerCall(calls, [&](const std::size_t) {
+            Kernels::advance(pos.data(), vel.data(), speed.data(), count, 1.f);
+            Bench::keep(pos[0]);
+        })};
+        // alternate the sign so the values stay put
+        const double add {Bench::timePerCall(calls, [&](const std::size_t i) {
+            Kernels::add(vel.data(), count, i % 2 == 0 ? 0.16f : -0.16f);
+            Bench::keep(vel[0]);
+        })};
+        const double scale {Bench::timePerCall(calls, [&](const std::size_t i) {
+            Kernels::scale(speed.data(), count, i % 2 == 0 ? 0.5f : 2.f);
+            Bench::keep(speed[0]);
+        })};
+        const double cull {Bench::timePerCall(calls, [&](const std::size_t) {
+            Bench::keep(Kernels::findDead(life.data(), 0, count));
+        })};
+
+        Bench::report(name + " integrate (pos += vel * dt)", perMicro / integrate, "particles/us");
+        Bench::report(name + " advance (pos += dir * speed * dt)", perMicro / advance, "particles/us");
+        Bench::report(name + " add (gravity, decay)", perMicro / add, "particles/us");
+        Bench::report(name + " scale (friction)", perMicro / scale, "particles/us");
+        Bench::report(name + " cull scan", perMicro / cull, "particles/us");
+    }
+    Kernels::setLevel(best);
+}
@@ -0,0 +1,67 @@
+#include "bench.hpp"
+
+#include "../src/tiles.hpp"
+#include "../src/levelfile.hpp"
+#include "../src/util.hpp"
+
+#include <algorithm>
+#include <string>
+
+void benchLevel()
+{
+    const std::unique_ptr<World> world {std::make_unique<World>()};
+
+    // std::cout spam from the loaders would swamp the timings
+    std::streambuf* out {std::cout.rdbuf(nullptr)};
+
+    const double json {Bench::timePerCall(20, [&](const std::size_t) {
+        world->loadJson("data/maps/0.json");
+    })};
+    const double compiled {Bench::timePerCall(200, [&](const std::size_t) {
+        world->loadCompiled("data/maps/0.lvl");
+    })};
+
+    std::cout.rdbuf(out);
+    Bench::report("World::loadJson (data/maps/0.json)", json / 1e6, "ms");
+    Bench::report("World::loadCompiled (data/maps/0.lvl)", compiled / 1e6, "ms");
+
+    // pan the camera back and forth across the level with a small budget, chunks stream in and get evicted
+    world->setChunkBudget(24);
+    const Rectangle start {Util::getViewRect({0, 0}, CST::SCR_WIDTH, CST::SCR_HEIGHT)};
+    const float span {std::max(1.f, world->getPixelWidth() - start.width)};
+    std::size_t maxResident {0};
+    const double pan {Bench::timePerCall(20000, [&](const std::size_t i) {
+        const float t {static_cast<float>(i % 2000) / 1000.f};
+        const float x {(t < 1.f ? t : 2.f - t) * span};
+        world->stream({x, world->getPixelHeight() * 0.5f - start.height * 0.5f, start.width, start.height});
+        maxResident = std::max(maxResident, world->getResidentChunks());
+    })};
+    Bench::report("World::stream pan (budget 24, max " + std::to_string(maxResident) + " resident)", pan / 1000.0, "us/frame");
+
+    // carve along the pan so edited chunks keep getting stashed and restored, then bring the whole level in
+    // and check no edit went missing: every tile has to agree with the solid bitmap
+    int broken {0};
+    for (std::size_t i{0}; i < 4000; ++i)
+    {
+        const float t {static_cast<float>(i % 2000) / 1000.f};
+        const float x {(t < 1.f ? t : 2.f - t) * span};
+        const Rectangle view {x, world->getPixelHeight() * 0.5f - start.height * 0.5f, start.width, start.height};
+        world->stream(view);
+        broken += world->damageTilesInRadius({view.x + view.width * 0.5f, view.y + view.height * 0.5f + static_cast<float>(i % 7) * 12.f}, 14.f, 11.f);
+    }
+    world->setChunkBudget(1 << 20);
+    world->stream({0.f, 0.f, world->getPixelWidth(), world->getPixelHeight()});
+    std::size_t mismatched {0};
+    for (int y{0}; y < world->getHeightChunks() * CST::CHUNK_SIZE; ++y)
+    {
+        for (int x{0}; x < world->getWidthChunks() * CST::CHUNK_SIZE; ++x)
+        {
+            mismatched += (world->getTile(x, y) != nullptr) != world->isSolid(x, y);
+        }
+    }
+    Bench::report("tiles broken while panning", static_cast<double>(broken), "tiles");
+    if (mismatched > 0)
+    {
+        Bench::fail(std::to_string(mismatched) + " tiles disagree with the solid bitmap after eviction");
+    }
+}
@@ -0,0 +1,36 @@
+#include "bench.hpp"
+
+#include <array>
+#include <string>
+
+void benchLod()
+{
+    const std::unique_ptr<World> world {Bench::loadLevel()};
+    const float width {world->getPixelWidth()};
+    const float height {world->getPixelHeight()};
+
+    // the same wanderers seen from three cameras: over the level, just off its right edge so the whole level is
+    // within a screen of it, and nowhere near. the player stays far off so only the camera decides
+    const std::array<std::pair<const char*, Rectangle>, NUM_ENEMY_LODS> cameras {{
+        {"full", {0.f, 0.f, width, height}},
+        {"offscreen", {width + 64.f, 0.f, width + 64.f, height}},
+        {"far", {width * 10.f, height * 10.f, 320.f, 180.f}},
+    }};
+    for (const auto& [name, camera] : cameras)
+    {
+        constexpr std::size_t count {10'000};
+        Bench::EnemyScene scene {world.get(), count};
+        scene.player.setPos({width * 10.f, height * 10.f});
+        scene.spawn(world.get(), count);
+
+        // long enough for every reduced tick to come round several times, the cost is amortised over all frames
+        const double frame {Bench::timePerCall(640, [&](const std::size_t) {
+            for (std::size_t type{0}; type < NUM_ENEMY_TYPES; ++type)
+            {
+                Enemies::update(scene.pools[type], scene.anims, 1.f, world.get(), &scene.player, &scene.flow, camera, scene.events);
+            }
+            scene.events.dispatch();
+        })};
+        Bench::report(std::string{"wanderer update, "} + name, frame / static_cast<double>(count), "ns/enemy");
+    }
+}
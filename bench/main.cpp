@@ -0,0 +1,80 @@
+#include "bench.hpp"
+
+#include <cstring>
+#include <functional>
+#include <map>
+#include <string>
+
+namespace
+{
+    std::size_t s_failures {0};
+}
+
+void Bench::fail(const std::string& what)
+{
+    ++s_failures;
+    std::cout << "  FAILED: " << what << '\n';
+}
+
+std::size_t Bench::failureCount()
+{
+    return s_failures;
+}
+
+// benchmark entry points (one file per subsystem)
+void benchTiles();
+void benchLevel();
+void benchView();
+void benchRay();
+void benchPhysics();
+void benchNavigation();
+void benchEnemies();
+void benchBroadphase();
+void benchPool();
+void benchJobs();
+void benchLod();
+void benchWaves();
+void benchParticles();
+void benchKernels();
+
+int main(int argc, char* argv[])
+{
+    const std::map<std::string, std::function<void()>> benches {
+        {"tiles", benchTiles},
+        {"level", benchLevel},
+        {"view", benchView},
+        {"ray", benchRay},
+        {"physics", benchPhysics},
+        {"navigation", benchNavigation},
+        {"enemies", benchEnemies},
+        {"broadphase", benchBroadphase},
+        {"pool", benchPool},
+        {"jobs", benchJobs},
+        {"lod", benchLod},
+        {"waves", benchWaves},
+        {"particles", benchParticles},
+        {"kernels", benchKernels},
+    };
+
+    // run everything if no names were given
+    for (const auto& [name, fn] : benches)
+    {
+        bool selected {argc < 2};
+        for (int i{1}; i < argc; ++i)
+        {
+            selected = selected || std::strcmp(argv[i], name.c_str()) == 0;
+        }
+        if (selected)
+        {
+            std::cout << "[" << name << "]\n";
+            fn();
+        }
+    }
+
+    if (Bench::failureCount() > 0)
+    {
+        std::cout << Bench::failureCount() << " check(s) failed!\n";
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,51 @@
+#include "bench.hpp"
+
+#include "../src/navigation.hpp"
+
+#include <vector>
+#include <random>
+#include <string>
+
+void benchNavigation()
+{
+    const std::unique_ptr<World> world {Bench::loadLevel()};
+
+    // player sized targets all over the level, every one lands in a different cell
+    std::mt19937 rng{1234};
+    std::uniform_real_distribution<float> distX{0.f, world->getPixelWidth()};
+    std::uniform_real_distribution<float> distY{0.f, world->getPixelHeight()};
+    std::vector<Rectangle> targets(256);
+    for (Rectangle& rect : targets)
+    {
+        rect = {distX(rng), distY(rng), 7.f, 14.f};
+    }
+
+    FlowField flow{};
+    flow.update(world.get(), targets[0]);
+
+    // terrain edits force a graph rebuild
+    const double build {Bench::timePerCall(200, [&](const std::size_t i) {
+        world->placeTile(static_cast<int>(i % 100), 0, TileType::GRASS);
+        world->removeTile(static_cast<int>(i % 100), 0);
+        flow.update(world.get(), targets[i & 255]);
+    })};
+    Bench::report("FlowField rebuild + search", build / 1000.0, "us");
+
+    const double search {Bench::timePerCall(2000, [&](const std::size_t i) {
+        flow.update(world.get(), targets[i & 255]);
+    })};
+    Bench::report("FlowField search (player changed cell)", search / 1000.0, "us");
+
+    // cost per enemy once the field is up to date
+    std::vector<Rectangle> bodies(4096);
+    for (Rectangle& rect : bodies)
+    {
+        rect = {distX(rng), distY(rng), 6.f, 7.f};
+    }
+    int steps {0};
+    const double sample {Bench::timePerCall(4'000'000, [&](const std::size_t i) {
+        steps += flow.sample(bodies[i & 4095]).dir;
+    })};
+    Bench::keep(steps);
+    Bench::report("FlowField::sample", sample, "ns/enemy");
+}
@@ -0,0 +1,140 @@
+#include "bench.hpp"
+
+#include "../src/particles.hpp"
+
+#include <array>
+#include <cmath>
+#include <cstdlib>
+#include <limits>
+#include <memory>
+#include <string>
+#include <vector>
+
+void benchParticles()
+{
+    const std::unique_ptr<World> world {Bench::loadLevel()};
+
+    const AnimSet anims{};
+    std::unique_ptr<ParticleEngine> engine {std::make_unique<ParticleEngine>()};
+    engine->init(&anims, nullptr);
+    // the pools themselves are what's measured here, not the governor
+    engine->setLiveCap(std::numeric_limits<std::size_t>::max());
+
+    // a mix like a string of kills, topped back up every frame so ~100k are always alive and the
+    // short lived ones (sparks) churn through thousands of spawns and deaths a frame
+    constexpr std::array<std::size_t, NUM_PARTICLE_TYPES> target {30'000, 25'000, 15'000, 200, 14'800, 15'000};
+    const float width {world->getPixelWidth()};
+    const float height {world->getPixelHeight()};
+    const auto topUp {[&]() {
+        const auto pos {[&]() {return vec2<float>{Util::random() * width, Util::random() * height};}};
+        const auto vel {[](const float speed) {
+            const float angle {Util::random() * static_cast<float>(M_PI) * 2.f};
+            return vec2<float>{std::cos(angle) * speed, std::sin(angle) * speed};
+        }};
+        while (engine->getCount(PARTICLE_SPARK) < target[PARTICLE_SPARK])
+        {
+            engine->addSpark(pos(), Util::random() * static_cast<float>(M_PI) * 2.f, Util::random() * 3.f + 1.f);
+        }
+        while (engine->getCount(PARTICLE_KNOCKBACK) < target[PARTICLE_KNOCKBACK])
+        {
+            engine->addKnockback(pos(), vel(Util::random() * 3.f), RED);
+        }
+        while (engine->getCount(PARTICLE_SMOKE) < target[PARTICLE_SMOKE])
+        {
+            engine->addSmoke(pos(), vel(Util::random()));
+        }
+        while (engine->getCount(PARTICLE_SHOCKWAVE) < target[PARTICLE_SHOCKWAVE])
+        {
+            engine->addShockwave(pos(), 24.f);
+        }
+        while (engine->getCount(PARTICLE_FLAME) < target[PARTICLE_FLAME])
+        {
+            engine->explode(pos(), 1.f);
+        }
+        while (engine->getCount(PARTICLE_CINDER) < target[PARTICLE_CINDER])
+        {
+            engine->addCinder(pos(), vel(Util::random() * 4.f), ORANGE);
+        }
+    }};
+
+    std::srand(1234);
+    const auto frame {[&](const std::size_t) {
+        engine->update(1.f, world.get());
+        topUp();
+    }};
+    // warm up into the steady state
+    topUp();
+    for (std::size_t i{0}; i < 100; ++i)
+    {
+        frame(i);
+    }
+
+    constexpr std::size_t frames {300};
+    const std::size_t before {Bench::allocationCount()};
+    const double time {Bench::timePerCall(frames, frame)};
+    const std::size_t allocations {Bench::allocationCount() - before};
+    const double live {static_cast<double>(engine->getCount())};
+    Bench::report("particle frame, " + std::to_string(engine->getCount()) + " live", time / 1'000'000.0, "ms");
+    Bench::report("particle update + respawn", time / live, "ns/particle");
+    Bench::report("heap allocations per frame", static_cast<double>(allocations) / static_cast<double>(frames + 1), "allocs");
+    Bench::report("dropped at capacity", static_cast<double>(engine->getDropped()), "particles");
+    if (allocations > 0)
+    {
+        Bench::fail("particle steady state allocated " + std::to_string(allocations) + " times");
+    }
+
+    // 100k knockback-style particles in one pool, topped up so the count stays put
+    constexpr std::size_t bouncing {100'000};
+    BouncePool pool {bouncing, {0.6f, 0.99f, 0.02f, 0.16f}};
+    const auto fill {[&]() {
+        while (pool.size() < bouncing)
+        {
+            const float angle {Util::random() * static_cast<float>(M_PI) * 2.f};
+            const float speed {Util::random() * 3.f};
+            pool.add({Util::random() * width, Util::random() * height}, {std::cos(angle) * speed, std::sin(angle) * speed}, 10.f, RED);
+        }
+    }};
+    fill();
+
+    // the terrain test on its own, point by point against the whole batch
+    std::vector<std::uint32_t> hits(bouncing);
+    std::size_t single{0};
+    const double perPoint {Bench::timePerCall(100, [&](const std::size_t) {
+        single = 0;
+        for (std::size_t i{0}; i < bouncing; ++i)
+        {
+            single += world->isSolidAt(pool.x[i], pool.y[i]);
+        }
+        Bench::keep(single);
+    })};
+    std::size_t batched{0};
+    const double batch {Bench::timePerCall(100, [&](const std::size_t) {
+        batched = world->findSolid(pool.x.data(), pool.y.data(), bouncing, hits.data());
+        Bench::keep(batched);
+    })};
+    Bench::report("isSolidAt per point", perPoint / static_cast<double>(bouncing), "ns/particle");
+    Bench::report("findSolid batch", batch / static_cast<double>(bouncing), "ns/particle");
+    Bench::report("solid hits (per point / batch)", static_cast<double>(single) - static_cast<double>(batched), "difference");
+
+    const double bounce {Bench::timePerCall(300, [&](const std::size_t) {
+        pool.update(1.f, world.get());
+        fill();
+    })};
+    Bench::report("bounce frame, 100k live", bounce / 1'000'000.0, "ms");
+
+    // the governor against a run of slow frames, then fast ones
+    engine->clear();
+    std::size_t steps{0};
+    for (; steps < 600 && engine->getScale() > 0.1f; ++steps)
+    {
+        engine->govern(1.f, ParticleEngine::FRAME_BUDGET * 2.f);
+    }
+    Bench::report("frames to min scale at 2x budget", static_cast<double>(steps), "frames");
+    Bench::report("sparks per 30 at min scale", static_cast<double>(engine->emitCount(PARTICLE_SPARK, 30.f)), "particles");
+    Bench::report("smoke per 30 at min scale", static_cast<double>(engine->emitCount(PARTICLE_SMOKE, 30.f)), "particles");
+    for (steps = 0; steps < 6000 && engine->getScale() < 1.f; ++steps)
+    {
+        engine->govern(1.f, ParticleEngine::FRAME_BUDGET * 0.5f);
+    }
+    Bench::report("frames back to full at 0.5x budget", static_cast<double>(steps), "frames");
+}
@@ -0,0 +1,58 @@
+#include "bench.hpp"
+
+#include "../src/physics.hpp"
+#include "../src/constants.hpp"
+
+#include <vector>
+#include <random>
+#include <string>
+
+void benchPhysics()
+{
+    const std::unique_ptr<World> world {Bench::loadLevel()};
+
+    // enemy sized bodies scattered over the level, running around and falling onto the terrain
+    std::mt19937 rng{1234};
+    std::uniform_real_distribution<float> distX{0.f, world->getPixelWidth()};
+    std::uniform_real_distribution<float> distY{0.f, world->getPixelHeight()};
+    std::uniform_real_distribution<float> distVel{-3.f, 3.f};
+    for (const std::size_t count : {std::size_t{100}, std::size_t{10'000}})
+    {
+        std::vector<PhysicsBody> bodies(count, PhysicsBody{{0.f, 0.f}, {6, 7}});
+        for (PhysicsBody& body : bodies)
+        {
+            body.pos = {distX(rng), distY(rng)};
+        }
+
+        const double step {Bench::timePerCall(1000, [&](const std::size_t i) {
+            for (std::size_t b{i % 16}; b < bodies.size(); b += 16)
+            {
+                bodies[b].vel.x = distVel(rng);
+            }
+            Physics::step(bodies.data(), bodies.size(), 1.f, world.get());
+        })};
+        Bench::report("Physics::step " + std::to_string(count) + " bodies", step / static_cast<double>(count), "ns/body");
+    }
+
+    // a far wanderer's tick: 16 frames at full walking speed is more than a tile, it still can't get through
+    // a one tile wall. carve a strip with a floor and the wall a tile ahead of the body
+    constexpr int left {4};
+    constexpr int ground {8};
+    for (int x{left}; x < left + 8; ++x)
+    {
+        for (int y{ground - 4}; y < ground; ++y)
+        {
+            world->removeTile(x, y);
+        }
+        world->placeTile(x, ground, TileType::GRASS);
+    }
+    world->placeTile(left + 3, ground - 1, TileType::GRASS);
+    constexpr float tile {static_cast<float>(CST::TILE_SIZE)};
+    PhysicsBody walker {{(left + 2) * tile, ground * tile - 7.f}, {6, 7}};
+    walker.vel.x = 0.4f * walker.friction / (1.f - walker.friction);
+    Physics::snapToGround(&walker, 1, 16.f, world.get());
+    if (!walker.hitWall || walker.pos.x + 6.f > (left + 3) * tile)
+    {
+        Bench::fail("Physics::snapToGround walked through a one tile wall (x " + std::to_string(walker.pos.x) + ")");
+    }
+}
@@ -0,0 +1,99 @@
+#include "bench.hpp"
+
+#include "../src/spatialgrid.hpp"
+
+#include <atomic>
+#include <cstdlib>
+#include <new>
+#include <random>
+#include <string>
+
+// count every heap allocation the bench binary makes, so a benchmark can check a loop doesn't allocate
+namespace
+{
+    std::atomic<std::size_t> s_allocations {0};
+}
+
+void* operator new(const std::size_t size)
+{
+    ++s_allocations;
+    if (void* ptr {std::malloc(size > 0 ? size : 1)})
+    {
+        return ptr;
+    }
+    throw std::bad_alloc{};
+}
+
+std::size_t Bench::allocationCount()
+{
+    return s_allocations.load();
+}
+
+void operator delete(void* ptr) noexcept
+{
+    std::free(ptr);
+}
+
+void operator delete(void* ptr, std::size_t) noexcept
+{
+    std::free(ptr);
+}
+
+void benchPool()
+{
+    const std::unique_ptr<World> world {Bench::loadLevel()};
+    Bench::EnemyScene scene {world.get(), CST::MAX_ENEMIES};
+    SpatialGrid grid{};
+
+    // late wave churn: two spawns and two deaths a frame on top of a full enemy frame
+    std::mt19937 rng{1234};
+    std::uniform_real_distribution<float> distX{0.f, world->getPixelWidth()};
+    const auto frame {[&](const std::size_t i) {
+        for (int spawn{0}; spawn < 2; ++spawn)
+        {
+            const std::size_t type {(i + static_cast<std::size_t>(spawn)) % NUM_ENEMY_TYPES};
+            EnemyPool& pool {scene.pools[type]};
+            pool.add(scene.kinds[type], {distX(rng), -10.f});
+            if (pool.size() > 1000)
+            {
+                pool.remove(rng() % pool.size());
+            }
+        }
+        scene.flow.update(world.get(), scene.player.getRect());
+        grid.reset(world->getPixelWidth(), world->getPixelHeight());
+        for (std::size_t type{0}; type < NUM_ENEMY_TYPES; ++type)
+        {
+            Enemies::update(scene.pools[type], scene.anims, 1.f, world.get(), &scene.player, &scene.flow, scene.level, scene.events);
+            for (std::size_t e{0}; e < scene.pools[type].size(); ++e)
+            {
+                grid.add(Enemies::getRect(scene.pools[type], e), static_cast<std::uint32_t>(e));
+            }
+        }
+        grid.build();
+        scene.events.dispatch();
+    }};
+
+    // fill up to the steady state first
+    for (std::size_t i{0}; i < 2000; ++i)
+    {
+        frame(i);
+    }
+
+    const std::size_t before {s_allocations.load()};
+    const double time {Bench::timePerCall(1000, frame)};
+    const std::size_t allocations {s_allocations.load() - before};
+    Bench::report("churn frame, 2000 enemies", time / 1000.0, "us");
+    Bench::report("heap allocations per frame", static_cast<double>(allocations) / 1001.0, "allocs");
+    if (allocations > 0)
+    {
+        Bench::fail("steady state allocated " + std::to_string(allocations) + " times");
+    }
+
+    // spawn + despawn on their own
+    EnemyPool& pool {scene.pools[0]};
+    const double cycle {Bench::timePerCall(1'000'000, [&](const std::size_t i) {
+        pool.add(scene.kinds[0], {static_cast<float>(i & 1023), 0.f});
+        pool.remove(i % pool.size());
+    })};
+    Bench::report("EnemyPool add + remove", cycle, "ns");
+}
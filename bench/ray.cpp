@@ -0,0 +1,40 @@
+#include "bench.hpp"
+
+#include "../src/tiles.hpp"
+
+#include <vector>
+#include <random>
+#include <string>
+#include <cmath>
+
+void benchRay()
+{
+    const std::unique_ptr<World> world {Bench::loadLevel()};
+
+    // random rays from anywhere in the level, some start inside walls
+    constexpr std::size_t numRays {1 << 16};
+    std::mt19937 rng{1234};
+    std::uniform_real_distribution<float> distX{0.f, world->getPixelWidth()};
+    std::uniform_real_distribution<float> distY{0.f, world->getPixelHeight()};
+    std::uniform_real_distribution<float> distAngle{0.f, 2.f * PI};
+    std::vector<vec2<float>> origins(numRays);
+    std::vector<vec2<float>> dirs(numRays);
+    for (std::size_t i{0}; i < numRays; ++i)
+    {
+        const float angle {distAngle(rng)};
+        origins[i] = {distX(rng), distY(rng)};
+        dirs[i] = {std::cos(angle), std::sin(angle)};
+    }
+
+    std::size_t hits {0};
+    // one bullet tick at BigModda speed with dt capped, then line of sight sized casts
+    for (const float maxDist : {52.f, 200.f, 1000.f})
+    {
+        const double cast {Bench::timePerCall(2'000'000, [&](const std::size_t i) {
+            hits += world->raycast(origins[i & (numRays - 1)], dirs[i & (numRays - 1)], maxDist).hit;
+        })};
+        Bench::keep(hits);
+        Bench::report("World::raycast " + std::to_string(static_cast<int>(maxDist)) + "px", cast, "ns/cast");
+        Bench::report("World::raycast " + std::to_string(static_cast<int>(maxDist)) + "px", 1000.0 / cast, "Mcasts/s");
+    }
+}
@@ -0,0 +1,82 @@
+#include "bench.hpp"
+
+#include "../src/tiles.hpp"
+#include "../src/constants.hpp"
+
+#include <vector>
+#include <random>
+#include <string>
+
+void benchTiles()
+{
+    const std::unique_ptr<World> world {Bench::loadLevel()};
+    // keep the whole level resident so every lookup hits a loaded chunk
+    world->setChunkBudget(1 << 20);
+    world->stream({0.f, 0.f, world->getPixelWidth(), world->getPixelHeight()});
+
+    // random query points spread over the whole level
+    constexpr std::size_t numPoints {1 << 16};
+    std::mt19937 rng{1234};
+    std::uniform_real_distribution<float> distX{0.f, world->getPixelWidth()};
+    std::uniform_real_distribution<float> distY{0.f, world->getPixelHeight()};
+    std::vector<vec2<float>> points(numPoints);
+    for (vec2<float>& p : points)
+    {
+        p = {distX(rng), distY(rng)};
+    }
+
+    std::size_t hits {0};
+    const double tileAt {Bench::timePerCall(4'000'000, [&](const std::size_t i) {
+        const vec2<float>& p {points[i & (numPoints - 1)]};
+        hits += world->getTileAt(p.x, p.y) != nullptr;
+    })};
+    Bench::keep(hits);
+    Bench::report("World::getTileAt", tileAt, "ns/query");
+
+    const double chunkAt {Bench::timePerCall(4'000'000, [&](const std::size_t i) {
+        const vec2<float>& p {points[i & (numPoints - 1)]};
+        hits += world->getChunkAt(p.x, p.y) != nullptr;
+    })};
+    Bench::keep(hits);
+    Bench::report("World::getChunkAt", chunkAt, "ns/query");
+
+    const double solidAt {Bench::timePerCall(4'000'000, [&](const std::size_t i) {
+        const vec2<float>& p {points[i & (numPoints - 1)]};
+        hits += world->isSolidAt(p.x, p.y);
+    })};
+    Bench::keep(hits);
+    Bench::report("World::isSolidAt", solidAt, "ns/query");
+
+    // enemy sized body and a much bigger one
+    for (const vec2<float> size : {vec2<float>{6.f, 7.f}, vec2<float>{40.f, 40.f}})
+    {
+        const double query {Bench::timePerCall(2'000'000, [&](const std::size_t i) {
+            const vec2<float>& p {points[i & (numPoints - 1)]};
+            world->forEachSolidTile({p.x, p.y, size.x, size.y}, [&](const Rectangle& rect) {
+                hits += CheckCollisionRecs(rect, {p.x, p.y, size.x, size.y});
+            });
+        })};
+        Bench::keep(hits);
+        Bench::report("World::forEachSolidTile " + std::to_string(static_cast<int>(size.x)) + "x" + std::to_string(static_cast<int>(size.y)), query, "ns/query");
+    }
+
+    // terrain edits: knock a tile out and put it back, then cannon sized blasts
+    std::vector<vec2<int>> solid{};
+    world->forEachSolidTile({0.f, 0.f, world->getPixelWidth(), world->getPixelHeight()}, [&](const Rectangle& rect) {
+        solid.push_back({static_cast<int>(rect.x) / CST::TILE_SIZE, static_cast<int>(rect.y) / CST::TILE_SIZE});
+    });
+    const double edit {Bench::timePerCall(200'000, [&](const std::size_t i) {
+        const vec2<int>& p {solid[(i * 7919) % solid.size()]};
+        hits += world->removeTile(p.x, p.y);
+        hits += world->placeTile(p.x, p.y, TileType::GRASS);
+    })};
+    Bench::keep(hits);
+    Bench::report("World::removeTile + placeTile", edit, "ns/pair");
+
+    const double blast {Bench::timePerCall(200'000, [&](const std::size_t i) {
+        const vec2<float>& p {points[i & (numPoints - 1)]};
+        hits += world->damageTilesInRadius(p, 14.f, 11.f);
+    })};
+    Bench::keep(hits);
+    Bench::report("World::damageTilesInRadius r14", blast, "ns/blast");
+}
@@ -0,0 +1,67 @@
+#include "bench.hpp"
+
+#include "../src/tiles.hpp"
+#include "../src/util.hpp"
+
+#include <array>
+#include <string>
+
+// the chunk loop World::render used before it had a visibility query (window pixels used as chunk counts)
+static int legacyLoop(World* world, const vec2<int>& scroll, const int width, const int height)
+{
+    int visited {0};
+    int chunkX {static_cast<int>(std::floor(static_cast<float>(scroll.x) / static_cast<float>(CST::TILE_SIZE) / static_cast<float>(CST::CHUNK_SIZE)))};
+    int chunkY {static_cast<int>(std::floor(static_cast<float>(scroll.y) / static_cast<float>(CST::TILE_SIZE) / static_cast<float>(CST::CHUNK_SIZE)))};
+    for (int y{0}; y < std::floor(height / CST::TILE_SIZE) + 1; ++y)
+    {
+        for (int x{0}; x < std::floor(width / CST::TILE_SIZE) + 1; ++x)
+        {
+            int targetX {chunkX - 1 + x};
+            int targetY {chunkY - 1 + y};
+            if (0 <= targetX && targetX < world->getWidthChunks() && 0 <= targetY && targetY < world->getHeightChunks())
+            {
+                visited += world->getChunkAt(static_cast<float>(targetX * CST::CHUNK_SIZE * CST::TILE_SIZE), static_cast<float>(targetY * CST::CHUNK_SIZE * CST::TILE_SIZE)) != nullptr;
+            }
+        }
+    }
+    return visited;
+}
+
+static int rangeLoop(World* world, const Rectangle& view)
+{
+    int visited {0};
+    const ChunkRange range {world->getChunksInRect({view.x - DECOR_SIZE, view.y - DECOR_SIZE, view.width + DECOR_SIZE, view.height + DECOR_SIZE})};
+    for (int y{range.y0}; y <= range.y1; ++y)
+    {
+        for (int x{range.x0}; x <= range.x1; ++x)
+        {
+            visited += world->getChunkAt(static_cast<float>(x * CST::CHUNK_SIZE * CST::TILE_SIZE), static_cast<float>(y * CST::CHUNK_SIZE * CST::TILE_SIZE)) != nullptr;
+        }
+    }
+    return visited;
+}
+
+void benchView()
+{
+    const std::unique_ptr<World> world {Bench::loadLevel()};
+    world->setChunkBudget(1 << 20);
+    world->stream({0.f, 0.f, world->getPixelWidth(), world->getPixelHeight()});
+
+    const vec2<int> scroll {600, 300};
+    constexpr std::array<vec2<int>, 4> sizes {vec2<int>{1000, 800}, vec2<int>{1920, 1080}, vec2<int>{2560, 1440}, vec2<int>{3840, 2160}};
+    for (const vec2<int>& size : sizes)
+    {
+        const std::string name {std::to_string(size.x) + "x" + std::to_string(size.y)};
+        int visited {0};
+        const double legacy {Bench::timePerCall(2000, [&](const std::size_t) {
+            visited = legacyLoop(world.get(), scroll, size.x, size.y);
+        })};
+        Bench::report("legacy loop " + name + " (" + std::to_string(visited) + " chunks)", legacy / 1000.0, "us/frame");
+
+        const Rectangle view {Util::getViewRect(scroll, size.x, size.y)};
+        const double range {Bench::timePerCall(200000, [&](const std::size_t) {
+            visited = rangeLoop(world.get(), view);
+        })};
+        Bench::report("getChunksInRect " + name + " (" + std::to_string(visited) + " chunks)", range / 1000.0, "us/frame");
+    }
+}
@@ -0,0 +1,64 @@
+#include "bench.hpp"
+
+#include "../src/waves.hpp"
+#include "../src/entities.hpp"
+
+#include <algorithm>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <string>
+
+void benchWaves()
+{
+    std::streambuf* out {std::cout.rdbuf(nullptr)};
+    WaveDirector director{};
+    const bool loaded {director.loadFromFile("data/waves.json")};
+    std::cout.rdbuf(out);
+    if (!loaded)
+    {
+        std::cout << "  couldn't load data/waves.json, run from the build dir\n";
+        return;
+    }
+
+    // every field with the wrong type has to fall back to its default instead of throwing
+    const std::string badPath {std::filesystem::temp_directory_path() / "bench_waves_bad.json"};
+    {
+        std::ofstream bad {badPath};
+        bad << R"({"maxEnemies": "lots", "frameBudget": [6], "spawnPoints": [3, {"x": "left"}],
+            "waves": [{"duration": "long", "interval": ["a", 2], "budget": 1.5, "maxAlive": -4, "types": {"blobbo": "x", "penguin": 1}}, 7]})";
+    }
+    WaveDirector fallback{};
+    std::cout.rdbuf(nullptr);
+    const bool badLoaded {fallback.loadFromFile(badPath.c_str())};
+    std::cout.rdbuf(out);
+    std::filesystem::remove(badPath);
+    if (!badLoaded || fallback.getWaveCount() != 1)
+    {
+        Bench::fail("data/waves.json with wrongly typed fields didn't fall back to the defaults");
+    }
+
+    // an hour of play where nobody dies, the worst case for the population. no simulate, so the frame
+    // budget never kicks in and only the caps hold it back
+    std::srand(1234);
+    std::unique_ptr<EntityManager> entities {std::make_unique<EntityManager>()};
+    const vec2<float> player {594.f, 400.f};
+    constexpr std::size_t frames {60 * 60 * 60};
+    std::size_t peak {0};
+    const double update {Bench::timePerCall(frames, [&](const std::size_t) {
+        director.update(1.f, entities.get(), player, 0.0f);
+        peak = std::max(peak, entities->getEnemyCount());
+    })};
+
+    const WaveStats& stats {director.getStats()};
+    Bench::report("director update", update, "ns");
+    Bench::report("peak population, 1 hour", static_cast<double>(peak), "enemies");
+    Bench::report("final wave", static_cast<double>(stats.wave + 1), "of " + std::to_string(director.getWaveCount()));
+    Bench::report("despawned stragglers", static_cast<double>(stats.despawned), "enemies");
+    Bench::report("skipped spawns", static_cast<double>(stats.skipped), "spawns");
+    if (peak > director.getMaxEnemies())
+    {
+        Bench::fail("population peaked at " + std::to_string(peak) + ", over maxEnemies (" + std::to_string(director.getMaxEnemies()) + ")");
+    }
+}
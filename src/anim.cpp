@@ -0,0 +1,60 @@
+#include "anim.hpp"
+#include "assets.hpp"
+
+namespace
+{
+    struct ClipDef
+    {
+        AnimClipId id;
+        const char* texture;
+        AnimClip clip;
+    };
+
+    // width, height, length, speed, loop, origin
+    const ClipDef CLIP_DEFS[] {
+        {CLIP_PLAYER_IDLE, "player/idle", {9, 14, 6, 0.2f, true}},
+        {CLIP_PLAYER_RUN, "player/run", {9, 14, 10, 0.35f, true}},
+        {CLIP_PLAYER_JUMP, "player/jump", {9, 14, 1, 0.1f, true}},
+        {CLIP_PLAYER_LAND, "player/land", {9, 14, 8, 0.5f, false}},
+        {CLIP_PLAYER_DAMAGE, "player/damage", {9, 14, 14, 1.0f, true}},
+
+        {CLIP_BLOBBO_IDLE, "blobbo/idle", {8, 8, 5, 0.2f, true}},
+        {CLIP_BLOBBO_RUN, "blobbo/run", {8, 8, 4, 0.2f, true}},
+        {CLIP_BLOBBO_ATTACK, "blobbo/attack", {8, 8, 5, 0.5f, true}},
+        {CLIP_BLOBBO_DAMAGE, "blobbo/damage", {8, 8, 1, 0.1f, true}},
+        {CLIP_PENGUIN_IDLE, "penguin/idle", {5, 8, 5, 0.15f, true}},
+        {CLIP_PENGUIN_RUN, "penguin/run", {5, 8, 4, 0.2f, true}},
+        {CLIP_PENGUIN_DAMAGE, "penguin/damage", {5, 8, 1, 0.1f, true}},
+
+        {CLIP_BLASTER, "blasters/default", {12, 5, 3, 0.5f, true, {6.f, 2.5f}}},
+        {CLIP_FIRE_BLASTER, "blasters/fire_blaster", {12, 5, 3, 0.5f, true, {6.f, 2.5f}}},
+        {CLIP_CANNON, "blasters/cannon", {12, 5, 1, 0.5f, true, {6.f, 2.5f}}},
+        {CLIP_EXTERMINATOR, "blasters/exterminator", {12, 5, 1, 0.5f, true, {6.f, 2.5f}}},
+        {CLIP_BIG_MODDA, "blasters/big_modda", {12, 5, 1, 0.5f, true, {6.f, 2.5f}}},
+
+        {CLIP_LASER, "bullets/laser", {8, 1, 1, 0.1f, true, {4.f, 0.5f}}},
+        {CLIP_FIRE_BULLET, "bullets/fire_bullet", {8, 3, 1, 0.1f, true, {4.f, 1.5f}}},
+        {CLIP_BALL, "bullets/ball", {6, 6, 1, 0.1f, true, {3.f, 3.f}}},
+        {CLIP_SHELL, "bullets/shell", {8, 3, 1, 0.1f, true, {4.f, 1.5f}}},
+        {CLIP_BOMB, "bullets/bomb", {12, 5, 1, 0.1f, true, {6.f, 2.5f}}},
+
+        {CLIP_FLAME, "flame", {5, 5, 9, 0.4f, false}},
+        {CLIP_FLAME_FAST, "flame", {5, 5, 9, 1.f, false}},
+    };
+}
+
+AnimSet::AnimSet()
+{
+    for (const ClipDef& def : CLIP_DEFS)
+    {
+        m_clips[def.id] = def.clip;
+    }
+}
+
+void AnimSet::loadTextures(AssetManager* assets)
+{
+    for (const ClipDef& def : CLIP_DEFS)
+    {
+        m_clips[def.id].tex = assets->getTexture(def.texture);
+    }
+}
@@ -5,114 +5,126 @@
 
 #include "vec2.hpp"
 
+#include <array>
 #include <cmath>
+#include <cstdint>
+#include <algorithm>
 
-class Anim
+class AssetManager;
+
+// every sprite sheet strip in the game, index into the AnimSet
+enum AnimClipId : std::uint16_t
 {
-public:
-    Anim(int w, int h, int length, float speed, bool loop, Texture2D* texture)
-     : m_width{w}, m_height{h}, m_length{length}, m_speed{speed}, m_loop{loop}, m_tex{texture}
-    {
-    }
+    // player
+    CLIP_PLAYER_IDLE,
+    CLIP_PLAYER_RUN,
+    CLIP_PLAYER_JUMP,
+    CLIP_PLAYER_LAND,
+    CLIP_PLAYER_DAMAGE,
+    // enemies
+    CLIP_BLOBBO_IDLE,
+    CLIP_BLOBBO_RUN,
+    CLIP_BLOBBO_ATTACK,
+    CLIP_BLOBBO_DAMAGE,
+    CLIP_PENGUIN_IDLE,
+    CLIP_PENGUIN_RUN,
+    CLIP_PENGUIN_DAMAGE,
+    // blasters
+    CLIP_BLASTER,
+    CLIP_FIRE_BLASTER,
+    CLIP_CANNON,
+    CLIP_EXTERMINATOR,
+    CLIP_BIG_MODDA,
+    // bullets
+    CLIP_LASER,
+    CLIP_FIRE_BULLET,
+    CLIP_BALL,
+    CLIP_SHELL,
+    CLIP_BOMB,
+    // particles
+    CLIP_FLAME,
+    CLIP_FLAME_FAST,
+    NUM_ANIM_CLIPS
+};
 
-    ~Anim() = default;
+// how far into a clip one instance is, small enough to keep in an array per enemy / particle
+struct AnimState
+{
+    float frame{0.0f};
+    AnimClipId clip{CLIP_PLAYER_IDLE};
+    bool flipped{false};
 
-    void render(const vec2<float>& pos, const vec2<int>& scroll)
+    // switch clips, starting the new one from the top
+    void play(const AnimClipId id)
     {
-        if (m_tex != nullptr)
+        if (clip != id)
         {
-            DrawTexturePro(*m_tex, getSourceRect(), {std::floor(pos.x - (float)scroll.x), std::floor(pos.y - (float)scroll.y), (float)m_width, (float)m_height}, {std::floor(m_origin.x), std::floor(m_origin.y)}, m_angle, WHITE);
+            clip = id;
+            frame = 0.0f;
         }
     }
+};
 
-    void reset()
-    {
-        m_step = 0;
-        m_frame = 0.0f;
-        m_finished = false;
-    }
-
-    void tick(const float dt)
+// one sprite sheet strip, never changes once loaded
+struct AnimClip
+{
+    int width{0};
+    int height{0};
+    int length{1};
+    float speed{0.0f};
+    bool loop{true};
+    vec2<float> origin{0.0f, 0.0f}; // rotation / placement origin
+    Texture2D* tex{nullptr};
+
+    [[nodiscard]] int getStep(const AnimState& state) const
     {
-        m_frame += m_speed * dt;
-        if (!m_loop)
+        if (!loop)
         {
-            if (m_frame > (float)m_length)
-            {
-                m_finished = true;
-            }
             // cap frame to last anim. frame
-            m_step = std::min(static_cast<int>(m_frame), m_length - 1);
-        } else {
-            m_step = static_cast<int>(m_frame) % m_length;
+            return std::min(static_cast<int>(state.frame), length - 1);
         }
+        return static_cast<int>(state.frame) % length;
     }
 
-    void setTex(Texture2D* tex) {m_tex = tex;}
-    [[nodiscard]] Texture2D* getTex() const {return m_tex;}
+    [[nodiscard]] bool getFinished(const AnimState& state) const {return !loop && state.frame > static_cast<float>(length);}
+};
 
-    Rectangle getSourceRect() const
-    {
-        return Rectangle{std::floor(static_cast<float>(m_step * m_width)), 0.f,
-            std::floor(static_cast<float>(m_flipped ? -m_width : m_width)), std::floor(static_cast<float>(m_height))};
-    }
+// every clip in the game, built once and shared by everything that draws a sprite
+class AnimSet
+{
+public:
+    // fills in the clip sizes and speeds, no textures until loadTextures (so it works headless)
+    AnimSet();
 
-    vec2<float> getCenter() const
-    {
-        return {
-            /*static_cast<float>(m_width * m_step) + */static_cast<float>(m_width) / 2.0f,
-            static_cast<float>(m_height) / 2.0f
-        };
-    }
+    void loadTextures(AssetManager* assets);
 
-    // getters
-    [[nodiscard]] int getWidth() const {return m_width;}
-    [[nodiscard]] int getHeight() const {return m_height;}
-    [[nodiscard]] int getLength() const {return m_length;}
+    [[nodiscard]] const AnimClip& get(const AnimClipId id) const {return m_clips[id];}
 
-    void setSpeed(const float val)
+    // advance every state by its clip's speed
+    void tick(AnimState* states, const std::size_t count, const float dt) const
     {
-        m_speed = std::max(0.0f, val);
+        for (std::size_t i{0}; i < count; ++i)
+        {
+            states[i].frame += m_clips[states[i].clip].speed * dt;
+        }
     }
-    [[nodiscard]] float getSpeed() const {return m_speed;}
 
-    void setFlipped(const bool val)
-    {
-        m_flipped = val;
-    }
-    [[nodiscard]] bool getFlipped() const {return m_flipped;}
+    [[nodiscard]] bool getFinished(const AnimState& state) const {return m_clips[state.clip].getFinished(state);}
 
-    [[nodiscard]] int getStep() const {return m_step;}
-    [[nodiscard]] float getFrame() const {return m_frame;}
-    void setFrame(const float frame)
+    void render(const AnimState& state, const vec2<float>& pos, const vec2<int>& scroll, const float angle = 0.0f) const
     {
-        m_frame = frame;
-        m_step = static_cast<int>(m_frame) % m_length;
+        const AnimClip& clip {m_clips[state.clip]};
+        if (clip.tex != nullptr)
+        {
+            const Rectangle src {std::floor(static_cast<float>(clip.getStep(state) * clip.width)), 0.f,
+                std::floor(static_cast<float>(state.flipped ? -clip.width : clip.width)), std::floor(static_cast<float>(clip.height))};
+            DrawTexturePro(*clip.tex, src, {std::floor(pos.x - (float)scroll.x), std::floor(pos.y - (float)scroll.y), (float)clip.width, (float)clip.height},
+                {std::floor(clip.origin.x), std::floor(clip.origin.y)}, angle, WHITE);
+        }
     }
-    [[nodiscard]] bool getFinished() const {return m_finished;}
-
-    void setAngle(const float val) {m_angle = val;}
-    [[nodiscard]] float getAngle() const {return m_angle;}
-
-    void setOrigin(const vec2<float>& val) {m_origin = val;}
-    [[nodiscard]] vec2<float> getOrigin() const {return m_origin;}
 
 private:
-    int m_width;
-    int m_height;
-    int m_length;
-    float m_speed;
-    bool m_loop;
-    Texture2D* m_tex;
-
-    bool m_flipped{false};
-
-    float m_frame{0.0f};
-    int m_step{0};
-    bool m_finished{false};
-
-    float m_angle{0.0f};
-    vec2<float> m_origin{0.0f, 0.0f};
+    std::array<AnimClip, NUM_ANIM_CLIPS> m_clips{};
 };
 
 #endif
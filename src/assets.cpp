@@ -70,6 +70,9 @@ void AssetManager::init()
     addTexture("noise", "data/images/noise.png");
     addTexture("light", "data/images/light.png");
 
+    // animation clips point at the textures above
+    m_anims.loadTextures(this);
+
     addFont("pixel", "data/fonts/PixelOperator8.ttf"); // custom font
     addShader("screenShader", "data/shaders/screenShader.frag"); // post processing shader
 
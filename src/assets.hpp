@@ -6,6 +6,8 @@
 
 #include <raylib.h>
 
+#include "anim.hpp"
+
 class AssetManager
 {
 public:
@@ -35,11 +37,16 @@ public:
     bool soundExists(const std::string& name) const;
     Sound* getSound(const std::string& name);
 
+    // every animation clip, textures are hooked up in init()
+    [[nodiscard]] const AnimSet* getAnims() const {return &m_anims;}
+
 private:
     std::map<std::string, Texture2D> m_textures{};
     std::map<std::string, Font> m_fonts{};
     std::map<std::string, Shader> m_shaders{};
     std::map<std::string, Sound> m_sounds{};
+
+    AnimSet m_anims{};
 };
 
 #endif
@@ -1,5 +1,6 @@
 #include "blasters.hpp"
 #include "util.hpp"
+#include "debug.hpp"
 
 #include <cmath>
 
@@ -15,11 +16,10 @@ Blaster::~Blaster()
 
 void Blaster::init(AssetManager* assets)
 {
-    m_anim = new Anim{12, 5, 3, 0.5f, true, assets->getTexture("blasters/default")};
-    m_anim->setOrigin({6.f, 2.5f});
-    m_bulletAnim = new Anim{8, 1, 1, 0.1, true, assets->getTexture("bullets/laser")};
-    m_bulletAnim->setOrigin({4.f, 0.5f});
-    m_sparkManager = new SparkManager{assets};
+    m_anims = assets->getAnims();
+    m_anim = AnimState{0.0f, CLIP_BLASTER};
+    m_bulletAnim = AnimState{0.0f, CLIP_LASER};
+    m_blank = assets->getTexture("blank");
 }
 
 void Blaster::update(const float dt, World* world)
@@ -27,11 +27,13 @@ void Blaster::update(const float dt, World* world)
     m_timer += dt;
     m_pos = m_player->getCenter();
     m_flipped = m_player->getFlipped();
-    m_anim->setSpeed(std::max(0.f, 1.f - m_timer * 0.01f));
-    m_anim->tick(dt);
-    m_anim->setAngle(m_angle);
+    // the barrel spins down after each shot instead of playing at the clip's speed
+    m_anim.frame += std::max(0.f, 1.f - m_timer * 0.01f) * dt;
+    m_anim.flipped = m_flipped;
     m_angle = m_flipped ? PI : 0.f;
 
+    m_sparks.update(dt);
+
     // update bullets
     for (std::size_t i{0}; i < m_bullets.size(); ++i)
     {
@@ -56,26 +58,27 @@ void Blaster::free()
         delete m_bullets[i];
     }
     m_bullets.clear();
-    delete m_anim;
-    m_anim = nullptr;
-    delete m_bulletAnim;
-    m_bulletAnim = nullptr;
-    delete m_sparkManager;
+    m_sparks.clear();
 }
 
-void Blaster::render(const vec2<int>& scroll)
+void Blaster::render(const Rectangle& view) const
 {
-    m_sparkManager->update(1.f, scroll);
-    m_anim->setFlipped(m_flipped);
-    m_anim->render({m_pos.x + m_offset.x + (m_flipped ? -stats.armLength : stats.armLength), m_pos.y + m_offset.y}, scroll);
+    const vec2<int> scroll {static_cast<int>(view.x), static_cast<int>(view.y)};
+    m_sparks.render(view, m_blank, DBG::blasterSparkDrawCalls);
+    m_anims->render(m_anim, {m_pos.x + m_offset.x + (m_flipped ? -stats.armLength : stats.armLength), m_pos.y + m_offset.y}, scroll, m_angle);
 }
 
-void Blaster::renderBullets(const vec2<int>& scroll)
+void Blaster::renderBullets(const Rectangle& view) const
 {
-    // render bullets
+    const vec2<int> scroll {static_cast<int>(view.x), static_cast<int>(view.y)};
+    // render bullets, but only the ones on the screen
     for (std::size_t i{0}; i < m_bullets.size(); ++i)
     {
-        renderBullet(m_bullets[i], scroll);
+        const Bullet* bullet {m_bullets[i]};
+        if (Util::inView(view, {bullet->pos.x - stats.halfLength * 2.f, bullet->pos.y - stats.halfLength * 2.f, stats.halfLength * 4.f, stats.halfLength * 4.f}))
+        {
+            renderBullet(m_bullets[i], scroll);
+        }
     }
 }
 
@@ -88,33 +91,38 @@ void Blaster::fire()
             m_pos.x + m_offset.x + (m_flipped ? -stats.armLength : stats.armLength) * 2.f, // pos
             m_pos.y + m_offset.y},
             stats.speed, // speed
-            angle}); // angle
+            angle, // angle
+            {std::cos(angle), std::sin(angle)}}); // dir
         // reset timer
         m_timer = 0.0f;
         m_player->setOffset({-std::cos(m_angle) * stats.recoil, -std::sin(m_angle) * stats.recoil});
         for (std::size_t i{0}; i < static_cast<int>(Util::random() * 5.f + 2.f); ++i)
         {
-            m_sparkManager->addSpark({m_pos.x + m_offset.x + (m_flipped ? -stats.armLength : stats.armLength) * 2.f, m_pos.y + m_offset.y}, angle + Util::random() - 0.5f, Util::random() * 1.f + 0.5f);
+            m_sparks.add({m_pos.x + m_offset.x + (m_flipped ? -stats.armLength : stats.armLength) * 2.f, m_pos.y + m_offset.y}, angle + Util::random() - 0.5f, Util::random() * 1.f + 0.5f);
         }
     }
 }
 
 void Blaster::updateBullet(Bullet* bullet, const float dt, World* world)
 {
-    bullet->pos.x += std::cos(bullet->angle) * bullet->speed * dt;
-    bullet->pos.y += std::sin(bullet->angle) * bullet->speed * dt;
-    Tile* tile {world->getTileAt(bullet->pos.x + std::cos(bullet->angle) * stats.halfLength,
-                                 bullet->pos.y + std::sin(bullet->angle) * stats.halfLength)};
-    if (tile != nullptr)
+    const vec2<float> dir {bullet->dir};
+    // sweep the tip over this tick's movement, fast bullets would skip whole tiles with a point check
+    const RayHit hit {world->raycast({bullet->pos.x + dir.x * stats.halfLength, bullet->pos.y + dir.y * stats.halfLength}, dir, bullet->speed * dt)};
+    if (hit.hit)
     {
-        if (Util::elementIn<TileType, std::size(SOLID_TILES)>(tile->type, SOLID_TILES.data()))
+        bullet->pos = {hit.pos.x - dir.x * stats.halfLength, hit.pos.y - dir.y * stats.halfLength};
+        for (std::size_t i{0}; i < static_cast<int>(Util::random() * 5.f + 2.f); ++i)
         {
-            for (std::size_t i{0}; i < static_cast<int>(Util::random() * 5.f + 2.f); ++i)
-            {
-                m_sparkManager->addSpark({bullet->pos.x + std::cos(bullet->angle) * stats.halfLength, bullet->pos.y + std::sin(bullet->angle) * stats.halfLength}, -bullet->angle + Util::random() - 0.5f, Util::random() * 1.f + 0.5f);
-            }
-            bullet->kill = true;
+            m_sparks.add(hit.pos, -bullet->angle + Util::random() - 0.5f, Util::random() * 1.f + 0.5f);
         }
+        if (stats.carveRadius > 0.0f)
+        {
+            world->damageTilesInRadius(hit.pos, stats.carveRadius, stats.damage);
+        }
+        bullet->kill = true;
+    } else {
+        bullet->pos.x += dir.x * bullet->speed * dt;
+        bullet->pos.y += dir.y * bullet->speed * dt;
     }
 
     bullet->timer += dt;
@@ -124,15 +132,9 @@ void Blaster::updateBullet(Bullet* bullet, const float dt, World* world)
     }
 }
 
-void Blaster::renderBullet(Bullet* bullet, const vec2<int>& scroll)
+void Blaster::renderBullet(const Bullet* bullet, const vec2<int>& scroll) const
 {
-    // only render bullet if it's on the screen
-    if (0.f - stats.halfLength * 2.f < bullet->pos.x - static_cast<float>(scroll.x)
-        && bullet->pos.x - static_cast<float>(scroll.x) < static_cast<float>(GetScreenWidth()) / CST::SCR_VRATIO + stats.halfLength * 2.f
-        && 0.f - stats.halfLength * 2.f < bullet->pos.y - static_cast<float>(scroll.y)
-        && bullet->pos.y - static_cast<float>(scroll.y) < static_cast<float>(GetScreenHeight()) / CST::SCR_VRATIO + stats.halfLength * 2.f)
-    {
-        m_bulletAnim->setFlipped(std::cos(bullet->angle) < 0.0f);
-        m_bulletAnim->render({bullet->pos.x, bullet->pos.y - 1.f}, scroll);
-    }
+    AnimState anim {m_bulletAnim};
+    anim.flipped = bullet->dir.x < 0.0f;
+    m_anims->render(anim, {bullet->pos.x, bullet->pos.y - 1.f}, scroll);
 }
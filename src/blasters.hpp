@@ -15,6 +15,7 @@ struct Bullet
     vec2<float> pos;
     float speed;
     float angle;
+    vec2<float> dir{}; // cos / sin of angle, worked out once when fired
     bool kill{false};
     float timer{0.0f};
 };
@@ -29,6 +30,7 @@ struct BlasterStats
     float knockBack; // bullet damage
     float recoil; // gun recoil animation
     float bulletRange; // bullet rect size
+    float carveRadius{0.0f}; // terrain damage radius on impact, 0 = doesn't carve
 };
 
 enum class Blasters
@@ -51,12 +53,14 @@ public:
     virtual void update(float dt, World* world);
     virtual void free();
 
-    virtual void render(const vec2<int>& scroll);
-    virtual void renderBullets(const vec2<int>& scroll);
+    // draws the arm and muzzle sparks
+    virtual void render(const Rectangle& view) const;
+    // draws the bullets that are inside the camera rect
+    virtual void renderBullets(const Rectangle& view) const;
 
     virtual void fire();
     virtual void updateBullet(Bullet* bullet, float dt, World* world);
-    virtual void renderBullet(Bullet* bullet, const vec2<int>& scroll);
+    virtual void renderBullet(const Bullet* bullet, const vec2<int>& scroll) const;
 
     [[nodiscard]] Player* getPlayer() const {return m_player;}
     [[nodiscard]] std::string_view getName() const {return m_name;}
@@ -73,9 +77,6 @@ public:
 
     const std::vector<Bullet*>& getBullets() const {return m_bullets;}
 
-    [[nodiscard]] virtual Anim* getAnim() const {return m_anim;}
-    [[nodiscard]] virtual Anim* getBulletAnim() const {return m_bulletAnim;}
-
     BlasterStats stats
     {
         4.f, // speed
@@ -92,7 +93,9 @@ protected:
     Player* m_player;
     std::string m_name;
 
-    SparkManager* m_sparkManager{nullptr};
+    // muzzle and impact sparks
+    SparkPool m_sparks{256};
+    Texture2D* m_blank{nullptr};
 
     vec2<float> m_offset;
     vec2<float> m_pos{};
@@ -102,8 +105,9 @@ protected:
     float m_recoil{0.0f};
     float m_rate{0.0f};
 
-    Anim* m_anim{nullptr};
-    Anim* m_bulletAnim{nullptr};
+    const AnimSet* m_anims{nullptr};
+    AnimState m_anim{};
+    AnimState m_bulletAnim{}; // shared by every bullet
 
     std::vector<Bullet*> m_bullets{};
 
@@ -121,11 +125,10 @@ public:
 
     void init(AssetManager* assets)
     {
-        m_anim = new Anim{12, 5, 3, 0.5f, true, assets->getTexture("blasters/fire_blaster")};
-        m_anim->setOrigin({6.f, 2.5f});
-        m_bulletAnim = new Anim{8, 3, 1, 0.1, true, assets->getTexture("bullets/fire_bullet")};
-        m_bulletAnim->setOrigin({4.f, 1.5f});
-        m_sparkManager = new SparkManager{assets};
+        m_anims = assets->getAnims();
+        m_anim = AnimState{0.0f, CLIP_FIRE_BLASTER};
+        m_bulletAnim = AnimState{0.0f, CLIP_FIRE_BULLET};
+        m_blank = assets->getTexture("blank");
         stats = BlasterStats{
             8.f, // speed
             5.f, // rate
@@ -149,11 +152,10 @@ public:
 
     void init(AssetManager* assets)
     {
-        m_anim = new Anim{12, 5, 1, 0.5f, true, assets->getTexture("blasters/cannon")};
-        m_anim->setOrigin({6.f, 2.5f});
-        m_bulletAnim = new Anim{6, 6, 1, 0.1, true, assets->getTexture("bullets/ball")};
-        m_bulletAnim->setOrigin({3.f, 3.f});
-        m_sparkManager = new SparkManager{assets};
+        m_anims = assets->getAnims();
+        m_anim = AnimState{0.0f, CLIP_CANNON};
+        m_bulletAnim = AnimState{0.0f, CLIP_BALL};
+        m_blank = assets->getTexture("blank");
         stats = BlasterStats{
             3.f, // speed
             20.f, // rate
@@ -163,22 +165,23 @@ public:
             70.f, // knockBack
             2.f, // recoil
             8.f, // bulletRange
+            14.f, // carveRadius
         };
     }
     
 
     void updateBullet(Bullet* bullet, const float dt, World* world)
     {
-        bullet->pos.x += std::cos(bullet->angle) * bullet->speed * dt;
-        bullet->pos.y += std::sin(bullet->angle) * bullet->speed * dt;
-        Tile* tile {world->getTileAt(bullet->pos.x + std::cos(bullet->angle) * stats.halfLength,
-                                    bullet->pos.y + std::sin(bullet->angle) * stats.halfLength)};
-        if (tile != nullptr)
+        const vec2<float> dir {bullet->dir};
+        const RayHit hit {world->raycast({bullet->pos.x + dir.x * stats.halfLength, bullet->pos.y + dir.y * stats.halfLength}, dir, bullet->speed * dt)};
+        if (hit.hit)
         {
-            if (Util::elementIn<TileType, std::size(SOLID_TILES)>(tile->type, SOLID_TILES.data()))
-            {
-                bullet->kill = true;
-            }
+            bullet->pos = {hit.pos.x - dir.x * stats.halfLength, hit.pos.y - dir.y * stats.halfLength};
+            world->damageTilesInRadius(hit.pos, stats.carveRadius, stats.damage);
+            bullet->kill = true;
+        } else {
+            bullet->pos.x += dir.x * bullet->speed * dt;
+            bullet->pos.y += dir.y * bullet->speed * dt;
         }
 
         bullet->timer += dt;
@@ -186,21 +189,17 @@ public:
         {
             bullet->kill = true;
         }
+
+        m_bulletAngle += 3.f * dt;
     }
 
-    void renderBullet(Bullet* bullet, const vec2<int>& scroll)
+    void renderBullet(const Bullet* bullet, const vec2<int>& scroll) const
     {
-        // only render bullet if it's on the screen
-        m_bulletAnim->setAngle(m_bulletAnim->getAngle() + 3.f);
-        if (0.f - stats.halfLength * 2.f < bullet->pos.x - static_cast<float>(scroll.x)
-            && bullet->pos.x - static_cast<float>(scroll.x) < static_cast<float>(GetScreenWidth()) / CST::SCR_VRATIO + stats.halfLength * 2.f
-            && 0.f - stats.halfLength * 2.f < bullet->pos.y - static_cast<float>(scroll.y)
-            && bullet->pos.y - static_cast<float>(scroll.y) < static_cast<float>(GetScreenHeight()) / CST::SCR_VRATIO + stats.halfLength * 2.f)
-        {
-            // m_bulletAnim->setFlipped(std::cos(bullet->angle) < 0.0f);
-            m_bulletAnim->render({bullet->pos.x, bullet->pos.y}, scroll);
-        }
+        m_anims->render(m_bulletAnim, {bullet->pos.x, bullet->pos.y}, scroll, m_bulletAngle);
     }
+
+private:
+    float m_bulletAngle{0.0f}; // cannon balls spin
 };
 
 class Exterminator : public Blaster
@@ -213,11 +212,10 @@ public:
 
     void init(AssetManager* assets)
     {
-        m_anim = new Anim{12, 5, 1, 0.5f, true, assets->getTexture("blasters/exterminator")};
-        m_anim->setOrigin({6.f, 2.5f});
-        m_bulletAnim = new Anim{8, 3, 1, 0.1, true, assets->getTexture("bullets/shell")};
-        m_bulletAnim->setOrigin({4.f, 1.5f});
-        m_sparkManager = new SparkManager{assets};
+        m_anims = assets->getAnims();
+        m_anim = AnimState{0.0f, CLIP_EXTERMINATOR};
+        m_bulletAnim = AnimState{0.0f, CLIP_SHELL};
+        m_blank = assets->getTexture("blank");
         stats = BlasterStats
         {
             10.f, // speed
@@ -242,11 +240,10 @@ public:
 
     void init(AssetManager* assets)
     {
-        m_anim = new Anim{12, 5, 1, 0.5f, true, assets->getTexture("blasters/big_modda")};
-        m_anim->setOrigin({6.f, 2.5f});
-        m_bulletAnim = new Anim{12, 5, 1, 0.1, true, assets->getTexture("bullets/bomb")};
-        m_bulletAnim->setOrigin({6.f, 2.5f});
-        m_sparkManager = new SparkManager{assets};
+        m_anims = assets->getAnims();
+        m_anim = AnimState{0.0f, CLIP_BIG_MODDA};
+        m_bulletAnim = AnimState{0.0f, CLIP_BOMB};
+        m_blank = assets->getTexture("blank");
         stats = BlasterStats{
             13.f, // speed
             10.f, // rate
@@ -256,6 +253,7 @@ public:
             100.f, // knockBack
             3.f, // recoil
             10.f, // bulletRange
+            20.f, // carveRadius
         };
     }
 };
@@ -11,9 +11,13 @@ namespace CST
 
     inline constexpr int TILE_SIZE{12};
     inline constexpr int CHUNK_SIZE{8};
-    inline constexpr int LEVEL_WIDTH{20};
-    inline constexpr int LEVEL_HEIGHT{20};
-    inline constexpr int NUM_CHUNKS{LEVEL_WIDTH * LEVEL_HEIGHT};
+    // max chunks kept in memory, the level itself can be any size
+    inline constexpr int CHUNK_BUDGET{64};
+    // chunks around the camera that get streamed in ahead of time
+    inline constexpr int STREAM_MARGIN{2};
+
+    // enemies of each type alive at once, spawns past this are skipped
+    inline constexpr int MAX_ENEMIES{4096};
 }
 
 #endif
@@ -0,0 +1,22 @@
+#ifndef DEBUG_H
+#define DEBUG_H
+
+// per frame counters for the debug overlay (see Game::drawFPS)
+namespace DBG
+{
+    inline int worldDrawCalls{0}; // chunk draws submitted by World::render
+    inline int sparkDrawCalls{0}; // triangle batches submitted for sparks
+    inline int blasterSparkDrawCalls{0}; // same for the blaster's own sparks
+    inline int cinderDrawCalls{0}; // same for cinders
+
+    // call once at the start of every frame
+    inline void resetFrame()
+    {
+        worldDrawCalls = 0;
+        sparkDrawCalls = 0;
+        blasterSparkDrawCalls = 0;
+        cinderDrawCalls = 0;
+    }
+}
+
+#endif
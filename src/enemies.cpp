@@ -0,0 +1,414 @@
+#include "enemies.hpp"
+#include "constants.hpp"
+#include "util.hpp"
+
+#include <cmath>
+#include <algorithm>
+
+// --------- EnemyPool --------- //
+
+EnemyPool::EnemyPool(const EnemyType type, const std::size_t capacity)
+ : m_type{type}, m_capacity{capacity}
+{
+    withArrays([capacity](auto&... arrays) {Util::reserveAll(capacity, arrays...);});
+
+    // every slot exists from the start, the free list hands out the low ones first
+    m_slots.resize(capacity);
+    m_freeSlots.reserve(capacity);
+    for (std::size_t slot{capacity}; slot > 0; --slot)
+    {
+        m_freeSlots.push_back(static_cast<std::uint32_t>(slot - 1));
+    }
+}
+
+EnemyHandle EnemyPool::add(const EnemyKind& kind, const vec2<float>& pos)
+{
+    if (m_freeSlots.empty())
+    {
+        return EnemyHandle{};
+    }
+    const std::uint32_t slot {m_freeSlots.back()};
+    m_freeSlots.pop_back();
+    m_slots[slot].index = static_cast<std::uint32_t>(size());
+    m_owners.push_back(slot);
+
+    bodies.push_back(PhysicsBody{pos, kind.dimensions});
+    anims.push_back(AnimState{0.0f, kind.clips[ENEMY_IDLE]});
+    health.push_back(kind.maxHealth);
+    falling.push_back(0.0f);
+    recovery.push_back(99.f);
+    timer.push_back(0.0f);
+    // bit of randomness
+    speed.push_back(Util::random() * kind.speedRange + kind.minSpeed);
+    rng.push_back(static_cast<std::uint32_t>(std::rand()) | 1u);
+    lod.push_back(LOD_FULL);
+    lodWait.push_back(0.0f);
+    walk.push_back(110.f);
+    walkTarget.push_back(100.f);
+    direction.push_back(1);
+    walking.push_back(true);
+    wandering.push_back(true);
+    attacking.push_back(false);
+
+    return EnemyHandle{m_type, slot, m_slots[slot].generation};
+}
+
+void EnemyPool::remove(const std::size_t index)
+{
+    const std::size_t last {size() - 1};
+
+    // the slot dies with the enemy, bumping the generation invalidates old handles
+    const std::uint32_t slot {m_owners[index]};
+    ++m_slots[slot].generation;
+    m_freeSlots.push_back(slot);
+
+    withArrays([index](auto&... arrays) {Util::swapRemove(index, arrays...);});
+    if (index != last)
+    {
+        m_slots[m_owners[index]].index = static_cast<std::uint32_t>(index);
+    }
+}
+
+void EnemyPool::clear()
+{
+    // same as removing them back to front: every handle dies and the slots go back on the free list
+    for (std::size_t index{size()}; index > 0; --index)
+    {
+        const std::uint32_t slot {m_owners[index - 1]};
+        ++m_slots[slot].generation;
+        m_freeSlots.push_back(slot);
+    }
+    withArrays([](auto&... arrays) {Util::clearAll(arrays...);});
+}
+
+bool EnemyPool::isValid(const EnemyHandle& handle) const
+{
+    return handle.type == m_type && handle.slot < m_slots.size() && m_slots[handle.slot].generation == handle.generation;
+}
+
+// --------- behaviour --------- //
+
+namespace
+{
+    // player is close by and there's no wall in between
+    bool canSeePlayer(const PhysicsBody& body, const vec2<float>& center, const World* world, const vec2<float>& target)
+    {
+        if (std::abs(target.x - body.pos.x) < CST::TILE_SIZE * 2 && std::abs(target.y - body.pos.y) < CST::TILE_SIZE * 2)
+        {
+            return world->lineOfSight(center, target);
+        }
+        return false;
+    }
+
+    // direction to walk towards the player (-1, 0, 1), follows the flow field if we're on it, jump is set when the path needs one
+    int getChaseDir(const PhysicsBody& body, const FlowField* flow, const vec2<float>& playerPos, bool& jump)
+    {
+        jump = false;
+        if (flow != nullptr)
+        {
+            const FlowStep step {flow->sample(body.getRect())};
+            if (step.valid && step.distance > 0)
+            {
+                jump = step.jump;
+                return step.dir;
+            }
+        }
+        // same cell as the player (or off the graph), head straight for them
+        if (playerPos.x > body.pos.x + 5.f)
+        {
+            return 1;
+        } else if (playerPos.x < body.pos.x - 5.f)
+        {
+            return -1;
+        }
+        return 0;
+    }
+
+    template <typename Traits>
+    EnemyAnim pickAnim(const EnemyPool& pool, const std::size_t i)
+    {
+        if (pool.recovery[i] <= Traits::RECOVERY_TIME)
+        {
+            return ENEMY_DAMAGE;
+        }
+        if (Traits::ATTACK_ANIM && pool.attacking[i])
+        {
+            return ENEMY_ATTACK;
+        }
+        if (pool.falling[i] > 3.0f || std::abs(pool.bodies[i].vel.x) > 0.1f)
+        {
+            return ENEMY_RUN;
+        }
+        return ENEMY_IDLE;
+    }
+
+    // the bits of the player every enemy reads, taken once before anyone moves
+    struct PlayerView
+    {
+        Rectangle rect;
+        vec2<float> pos;
+        vec2<float> center;
+        bool falling;
+    };
+
+    // frames between updates at each lod
+    constexpr std::array<float, NUM_ENEMY_LODS> LOD_INTERVALS {1.f, 4.f, 16.f};
+
+    template <typename Traits>
+    EnemyLod pickLod(const EnemyPool& pool, const std::size_t i, const Rectangle& camera, const PlayerView& player)
+    {
+        // anyone who's after the player or was just shot stays sharp
+        if (!pool.wandering[i] || pool.attacking[i] || pool.recovery[i] <= Traits::RECOVERY_TIME)
+        {
+            return LOD_FULL;
+        }
+        const PhysicsBody& body {pool.bodies[i]};
+        constexpr float margin {CST::TILE_SIZE * 2.f};
+        constexpr float playerRange {CST::TILE_SIZE * 6.f};
+        if (CheckCollisionRecs({camera.x - margin, camera.y - margin, camera.width + margin * 2.f, camera.height + margin * 2.f}, body.getRect())
+            || (std::abs(player.center.x - body.pos.x) < playerRange && std::abs(player.center.y - body.pos.y) < playerRange))
+        {
+            return LOD_FULL;
+        }
+        // within a screen of the camera
+        if (CheckCollisionRecs({camera.x - camera.width, camera.y - camera.height, camera.width * 3.f, camera.height * 3.f}, body.getRect()))
+        {
+            return LOD_OFFSCREEN;
+        }
+        return LOD_FAR;
+    }
+
+    template <typename Traits>
+    void updateFull(EnemyPool& pool, const AnimSet& anims, const float dt, const World* world, const PlayerView& player,
+        const FlowField* flow, const std::size_t i, EnemyEffects& effects)
+    {
+        PhysicsBody& body {pool.bodies[i]};
+        std::uint32_t& rng {pool.rng[i]};
+
+        // pick the animation, every clip of a type shares the frame counter
+        AnimState& anim {pool.anims[i]};
+        anim.clip = Traits::CLIPS[pickAnim<Traits>(pool, i)];
+
+        // basic movement
+        pool.walk[i] += dt;
+        if (!pool.wandering[i] || pool.attacking[i] || canSeePlayer(body, Enemies::getCenter(pool, i), world, player.center))
+        {
+            if (std::abs(player.pos.x - body.pos.x) < 1920.f)
+            {
+                bool jump {false};
+                const int dir {getChaseDir(body, flow, player.pos, jump)};
+                if (dir != 0)
+                {
+                    body.vel.x += pool.speed[i] * dt * 1.1f * static_cast<float>(dir);
+                    anim.flipped = dir < 0;
+                }
+                // the path goes up a ledge
+                if (jump && pool.falling[i] < 3.0f)
+                {
+                    body.vel.y = -2.f;
+                    pool.falling[i] = 4.0f;
+                }
+            }
+            if (CheckCollisionRecs(player.rect, body.getRect()))
+            {
+                ++effects.hits;
+            }
+        } else {
+            if (pool.walk[i] > pool.walkTarget[i])
+            {
+                pool.walk[i] = 0.0f;
+                pool.direction[i] = (Util::random(rng) > 0.5f) ? -1 : 1;
+                pool.walking[i] = !pool.walking[i];
+                pool.walkTarget[i] = pool.walking[i] ? (Util::random(rng) * 100 + 100.f) : (Util::random(rng) * 60.f + 20.f);
+            }
+
+            if (pool.walking[i])
+            {
+                body.vel.x += pool.speed[i] * static_cast<float>(pool.direction[i]);
+            } else {
+                body.vel.x += (body.vel.x * 0.1f - body.vel.x) * dt;
+            }
+
+            anim.flipped = pool.direction[i] < 0;
+        }
+
+        if (Util::random(rng) < (pool.attacking[i] ? 0.1 : 0.05) * dt)
+        {
+            if (pool.falling[i] < 3.0f)
+            {
+                body.vel.y = -2.f;
+                pool.falling[i] = 4.0f;
+            }
+        }
+
+        // player landed on us
+        if (player.falling)
+        {
+            if (CheckCollisionRecs(player.rect, body.getRect()) && body.vel.y < 1.0f)
+            {
+                ++effects.bounces;
+            }
+        }
+
+        pool.timer[i] += dt;
+        // air time and recover counters, capped so they don't overflow
+        pool.falling[i] = std::min(10000.f, pool.falling[i] + dt);
+        pool.recovery[i] = std::min(10000.f, pool.recovery[i] + dt);
+
+        anims.tick(&anim, 1, dt);
+
+        // update physics
+        Physics::step(&body, 1, dt, world);
+        if (body.landed)
+        {
+            pool.falling[i] = 0.0f;
+        }
+    }
+
+    // a wanderer nobody can see: the same random walk, no jumps or animation. walking speed goes straight to
+    // where friction would settle it, so a tick every few frames covers the same ground
+    void updateCoarse(EnemyPool& pool, const float dt, const World* world, const std::size_t i)
+    {
+        PhysicsBody& body {pool.bodies[i]};
+        std::uint32_t& rng {pool.rng[i]};
+
+        pool.walk[i] += dt;
+        if (pool.walk[i] > pool.walkTarget[i])
+        {
+            pool.walk[i] = 0.0f;
+            pool.direction[i] = (Util::random(rng) > 0.5f) ? -1 : 1;
+            pool.walking[i] = !pool.walking[i];
+            pool.walkTarget[i] = pool.walking[i] ? (Util::random(rng) * 100 + 100.f) : (Util::random(rng) * 60.f + 20.f);
+        }
+        if (pool.walking[i])
+        {
+            body.vel.x = pool.speed[i] * static_cast<float>(pool.direction[i]) * body.friction / (1.f - body.friction);
+        }
+        pool.anims[i].flipped = pool.direction[i] < 0;
+
+        pool.timer[i] += dt;
+        pool.falling[i] = std::min(10000.f, pool.falling[i] + dt);
+        pool.recovery[i] = std::min(10000.f, pool.recovery[i] + dt);
+
+        Physics::snapToGround(&body, 1, dt, world);
+        if (body.landed)
+        {
+            pool.falling[i] = 0.0f;
+        }
+    }
+
+    // everything for enemies [begin, end), only writes to those enemies and `effects`
+    template <typename Traits>
+    void updateRange(EnemyPool& pool, const AnimSet& anims, const float dt, const World* world, const PlayerView& player,
+        const FlowField* flow, const Rectangle& camera, const std::size_t begin, const std::size_t end, EnemyEffects& effects)
+    {
+        for (std::size_t i{begin}; i < end; ++i)
+        {
+            const EnemyLod lod {pickLod<Traits>(pool, i, camera, player)};
+            if (lod != pool.lod[i])
+            {
+                // start somewhere random in the interval so a crowd that drops a level doesn't all tick on the same frame
+                pool.lod[i] = lod;
+                pool.lodWait[i] = Util::random(pool.rng[i]) * LOD_INTERVALS[lod];
+            }
+
+            if (lod == LOD_FULL)
+            {
+                updateFull<Traits>(pool, anims, dt, world, player, flow, i, effects);
+                continue;
+            }
+
+            pool.lodWait[i] += dt;
+            if (pool.lodWait[i] >= LOD_INTERVALS[lod])
+            {
+                updateCoarse(pool, pool.lodWait[i], world, i);
+                pool.lodWait[i] = 0.0f;
+            }
+        }
+    }
+
+    template <typename Traits>
+    void updatePool(EnemyPool& pool, const AnimSet& anims, const float dt, World* world, Player* player, const FlowField* flow, const Rectangle& camera,
+        EventQueue& events, JobSystem* jobs)
+    {
+        const std::size_t count {pool.size()};
+        const PlayerView target {player->getRect(), player->getPos(), player->getCenter(), player->getVel().y > 0.2f};
+
+        std::array<EnemyEffects, JobSystem::MAX_WORKERS> effects{};
+        if (jobs != nullptr)
+        {
+            // big enough that a chunk outweighs the cost of handing it out
+            constexpr std::size_t grain {256};
+            jobs->parallelFor(count, grain, [&](const std::size_t begin, const std::size_t end, const std::size_t worker) {
+                updateRange<Traits>(pool, anims, dt, world, target, flow, camera, begin, end, effects[worker]);
+            });
+        } else {
+            updateRange<Traits>(pool, anims, dt, world, target, flow, camera, 0, count, effects[0]);
+        }
+
+        // handle beef with player. the player's recovery time makes extra hits in the same frame do nothing,
+        // so one damage call covers everyone who touched them
+        EnemyEffects total {};
+        for (const EnemyEffects& e : effects)
+        {
+            total.hits += e.hits;
+            total.bounces += e.bounces;
+        }
+        if (total.hits > 0 && player->damage(Traits::DANGER))
+        {
+            events.push(GameEvent{GameEventType::PLAYER_DAMAGED, player->getCenter(), {}, Traits::DANGER});
+        }
+        if (total.bounces > 0)
+        {
+            player->setVelY(-4.f);
+        }
+    }
+}
+
+std::array<EnemyKind, NUM_ENEMY_TYPES> Enemies::makeKinds()
+{
+    std::array<EnemyKind, NUM_ENEMY_TYPES> kinds {};
+    forEachArchetype([&kinds](auto archetype) {
+        using Traits = decltype(archetype);
+        kinds[static_cast<std::size_t>(Traits::TYPE)] = makeKind<Traits>();
+    });
+    return kinds;
+}
+
+EnemyType Enemies::typeFromName(const std::string& name)
+{
+    EnemyType type {EnemyType::NONE};
+    forEachArchetype([&](auto archetype) {
+        using Traits = decltype(archetype);
+        if (name == Traits::NAME)
+        {
+            type = Traits::TYPE;
+        }
+    });
+    return type;
+}
+
+void Enemies::update(EnemyPool& pool, const AnimSet& anims, const float dt, World* world, Player* player, const FlowField* flow, const Rectangle& camera,
+    EventQueue& events, JobSystem* jobs)
+{
+    forEachArchetype([&](auto archetype) {
+        using Traits = decltype(archetype);
+        if (pool.getType() == Traits::TYPE)
+        {
+            updatePool<Traits>(pool, anims, dt, world, player, flow, camera, events, jobs);
+        }
+    });
+}
+
+void Enemies::render(const EnemyPool& pool, const EnemyKind& kind, const AnimSet& anims, const Rectangle& view)
+{
+    const vec2<int> scroll {static_cast<int>(view.x), static_cast<int>(view.y)};
+    for (std::size_t i{0}; i < pool.size(); ++i)
+    {
+        const PhysicsBody& body {pool.bodies[i]};
+        if (Util::inView(view, body.getRect()))
+        {
+            anims.render(pool.anims[i], {body.pos.x + kind.spriteOffset.x, body.pos.y + kind.spriteOffset.y}, scroll);
+        }
+    }
+}
@@ -0,0 +1,224 @@
+#ifndef ENEMIES_H
+#define ENEMIES_H
+
+#include "raylib.h"
+
+#include "vec2.hpp"
+#include "tiles.hpp"
+#include "physics.hpp"
+#include "navigation.hpp"
+#include "anim.hpp"
+#include "player.hpp"
+#include "jobs.hpp"
+#include "events.hpp"
+
+#include <array>
+#include <string>
+#include <tuple>
+#include <vector>
+#include <cstdint>
+
+enum class EnemyType
+{
+    BLOBBO,
+    PENGUIN,
+    NONE
+};
+
+constexpr std::size_t NUM_ENEMY_TYPES {static_cast<std::size_t>(EnemyType::NONE)};
+
+// refers to one enemy for as long as it lives, stays valid while others are added and removed
+struct EnemyHandle
+{
+    EnemyType type{EnemyType::NONE};
+    std::uint32_t slot{0};
+    std::uint32_t generation{0};
+};
+
+enum EnemyAnim
+{
+    ENEMY_IDLE,
+    ENEMY_RUN,
+    ENEMY_ATTACK,
+    ENEMY_DAMAGE,
+    NUM_ENEMY_ANIMS
+};
+
+// how much simulation an enemy gets, picked every frame from how close it is to the camera and the player
+enum EnemyLod : std::uint8_t
+{
+    LOD_FULL, // every frame: ai, animation, swept physics
+    LOD_OFFSCREEN, // within a screen of the camera: every 4th frame, no animation, ground snapping physics
+    LOD_FAR, // everyone else: every 16th frame
+    NUM_ENEMY_LODS
+};
+
+// everything that's the same for every enemy of a type, known at compile time. an archetype inherits this
+// and hides whatever it does differently, Enemies::update is stamped out once per archetype so the
+// constants fold into the loop instead of being loaded per enemy
+struct EnemyTraits
+{
+    static constexpr vec2<int> DIMENSIONS {6, 7};
+    static constexpr vec2<float> SPRITE_OFFSET {0.f, 0.f}; // where the sprite goes relative to the body
+    static constexpr float DANGER {4.f}; // damage done to the player
+    static constexpr float MAX_HEALTH {10.f};
+    static constexpr float RECOVERY_TIME {10.f};
+    static constexpr float MIN_SPEED {0.1f};
+    static constexpr float SPEED_RANGE {0.3f};
+    static constexpr bool ATTACK_ANIM {true}; // false to keep using idle / run while attacking
+};
+
+struct BlobboTraits : EnemyTraits
+{
+    static constexpr EnemyType TYPE {EnemyType::BLOBBO};
+    static constexpr const char* NAME {"blobbo"};
+    static constexpr vec2<float> SPRITE_OFFSET {-1.f, -1.f};
+    static constexpr std::array<AnimClipId, NUM_ENEMY_ANIMS> CLIPS {CLIP_BLOBBO_IDLE, CLIP_BLOBBO_RUN, CLIP_BLOBBO_ATTACK, CLIP_BLOBBO_DAMAGE};
+};
+
+struct PenguinTraits : EnemyTraits
+{
+    static constexpr EnemyType TYPE {EnemyType::PENGUIN};
+    static constexpr const char* NAME {"penguin"};
+    static constexpr vec2<int> DIMENSIONS {5, 8};
+    static constexpr bool ATTACK_ANIM {false};
+    static constexpr std::array<AnimClipId, NUM_ENEMY_ANIMS> CLIPS {CLIP_PENGUIN_IDLE, CLIP_PENGUIN_RUN, CLIP_PENGUIN_RUN, CLIP_PENGUIN_DAMAGE};
+};
+
+// every archetype, a new enemy type is an EnemyType entry, a traits struct and a spot in this list
+using EnemyArchetypes = std::tuple<BlobboTraits, PenguinTraits>;
+static_assert(std::tuple_size_v<EnemyArchetypes> == NUM_ENEMY_TYPES, "every enemy type needs an archetype");
+
+// the traits as plain data, for the cold paths (spawning, drawing) that look types up at runtime
+struct EnemyKind
+{
+    vec2<int> dimensions{};
+    vec2<float> spriteOffset{};
+    float danger{0.0f};
+    float maxHealth{0.0f};
+    float recoveryTime{0.0f};
+    float minSpeed{0.0f};
+    float speedRange{0.0f};
+    bool attackAnim{false};
+    std::array<AnimClipId, NUM_ENEMY_ANIMS> clips{};
+};
+
+// every enemy of one type, stored as parallel arrays so the update walks memory in order
+//
+// live enemies are packed into [0, size()), removing one moves the last one into its place. handles go
+// through a slot table so they survive the shuffle, the generation catches handles to dead enemies.
+// everything is allocated up front for `capacity` enemies, spawning and dying never touch the heap
+class EnemyPool
+{
+public:
+    EnemyPool(EnemyType type, std::size_t capacity);
+
+    // returns a handle of type NONE if the pool is full
+    EnemyHandle add(const EnemyKind& kind, const vec2<float>& pos);
+    // swap-and-pop, the enemy that was last is now at index
+    void remove(std::size_t index);
+    void clear();
+
+    [[nodiscard]] bool isValid(const EnemyHandle& handle) const;
+    // index into the arrays, only call with a valid handle
+    [[nodiscard]] std::size_t indexOf(const EnemyHandle& handle) const {return m_slots[handle.slot].index;}
+
+    [[nodiscard]] std::size_t size() const {return bodies.size();}
+    [[nodiscard]] std::size_t getCapacity() const {return m_capacity;}
+    [[nodiscard]] EnemyType getType() const {return m_type;}
+
+    std::vector<PhysicsBody> bodies{};
+    std::vector<AnimState> anims{};
+    std::vector<float> health{};
+    std::vector<float> falling{}; // air time
+    std::vector<float> recovery{}; // time since last hit
+    std::vector<float> timer{}; // time alive
+    std::vector<float> speed{};
+    std::vector<std::uint32_t> rng{}; // own random stream, so updates give the same result on any thread
+    std::vector<EnemyLod> lod{};
+    std::vector<float> lodWait{}; // time since the last reduced lod tick
+    // wandering
+    std::vector<float> walk{};
+    std::vector<float> walkTarget{};
+    std::vector<std::int8_t> direction{};
+    std::vector<std::uint8_t> walking{};
+    // set by the EntityManager every frame
+    std::vector<std::uint8_t> wandering{};
+    std::vector<std::uint8_t> attacking{};
+
+private:
+    struct Slot
+    {
+        std::uint32_t index{0};
+        std::uint32_t generation{0};
+    };
+
+    EnemyType m_type;
+    std::size_t m_capacity;
+    std::vector<Slot> m_slots{};
+    std::vector<std::uint32_t> m_freeSlots{};
+    std::vector<std::uint32_t> m_owners{}; // slot of each packed enemy
+
+    // every per enemy array, so they all grow and shrink together. a new field goes here and in add
+    template <typename F>
+    void withArrays(F&& fn)
+    {
+        fn(bodies, anims, health, falling, recovery, timer, speed, rng, lod, lodWait, walk, walkTarget, direction, walking, wandering,
+            attacking, m_owners);
+    }
+};
+
+// what a pool did to the player in one update. gathered per worker and added up once everyone
+// has moved, so the outcome doesn't depend on which thread got which enemies
+struct alignas(64) EnemyEffects
+{
+    std::uint32_t hits{0}; // touched the player while chasing
+    std::uint32_t bounces{0}; // the player fell onto them
+};
+
+// per type behaviour, run over a whole pool at once
+namespace Enemies
+{
+    // calls fn(Traits{}) for every archetype in order
+    template <typename Fn>
+    void forEachArchetype(Fn&& fn)
+    {
+        std::apply([&fn](auto... archetype) {(fn(archetype), ...);}, EnemyArchetypes{});
+    }
+
+    template <typename Traits>
+    [[nodiscard]] constexpr EnemyKind makeKind()
+    {
+        return EnemyKind{Traits::DIMENSIONS, Traits::SPRITE_OFFSET, Traits::DANGER, Traits::MAX_HEALTH, Traits::RECOVERY_TIME,
+            Traits::MIN_SPEED, Traits::SPEED_RANGE, Traits::ATTACK_ANIM, Traits::CLIPS};
+    }
+
+    // one kind per type, indexed by EnemyType
+    [[nodiscard]] std::array<EnemyKind, NUM_ENEMY_TYPES> makeKinds();
+
+    // the type whose archetype goes by name (as used in data files), NONE if there isn't one
+    [[nodiscard]] EnemyType typeFromName(const std::string& name);
+
+    // wandering / chasing, an animation tick and a physics step, through the update built for the pool's archetype.
+    // wanderers away from the camera and the player drop to a cheaper lod and only tick now and then. with jobs
+    // the pool is split into chunks across the workers, the result is the same either way
+    void update(EnemyPool& pool, const AnimSet& anims, float dt, World* world, Player* player, const FlowField* flow, const Rectangle& camera,
+        EventQueue& events, JobSystem* jobs = nullptr);
+
+    void render(const EnemyPool& pool, const EnemyKind& kind, const AnimSet& anims, const Rectangle& view);
+
+    [[nodiscard]] inline Rectangle getRect(const EnemyPool& pool, const std::size_t i) {return pool.bodies[i].getRect();}
+    [[nodiscard]] inline vec2<float> getCenter(const EnemyPool& pool, const std::size_t i)
+    {
+        const PhysicsBody& body {pool.bodies[i]};
+        return vec2<float>{body.pos.x + static_cast<float>(body.dimensions.x) / 2.0f, body.pos.y + static_cast<float>(body.dimensions.y) / 2.0f};
+    }
+
+    inline void damage(EnemyPool& pool, const std::size_t i, const float amount)
+    {
+        pool.health[i] -= amount;
+        pool.recovery[i] = 0.0f;
+    }
+}
+
+#endif
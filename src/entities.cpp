@@ -5,593 +5,319 @@
 
 #include <raylib.h>
 
-Entity::Entity(const vec2<float>& pos, const vec2<int>& dimensions, const std::string& name)
-: m_pos{pos}, m_dimensions{dimensions}, m_name{name}
+// --------- Entity Manager --------- //
+EntityManager::EntityManager()
 {
+    // sized up front so spawning, dying and hit flashes don't allocate mid game
+    m_order.reserve(NUM_ENEMY_TYPES * CST::MAX_ENEMIES);
+    m_lights.reserve(MAX_LIGHTS);
 }
 
-// load assets or smth
-void Entity::init(AssetManager* assets)
+EntityManager::~EntityManager()
 {
-    std::cout << "Initialized `" << m_name << "`!\n";
+    free();
 }
 
-// handle physics
-void Entity::update(const float dt, World* world, Player* player, float& screenShake)
+void EntityManager::init(AssetManager* assets)
 {
-    constexpr float gravity {0.15f};
-    constexpr float friction {0.75f};
-    constexpr float offsetDecay {0.3f};
-
-    m_timer += dt;
-
-    // air time counter
-    m_falling += dt;
-    // recover counter
-    m_recovery += dt;
+    m_particles.init(assets->getAnims(), assets->getTexture("blank"));
+    m_lightTex = assets->getTexture("light");
 
-    // prevent overflow error lol?
-    m_falling = std::min(10000.f, m_falling);
-    m_recovery = std::min(10000.f, m_recovery);
+    m_anims = assets->getAnims();
+}
 
-    // take acount for deltatime with friction calculation
-    m_vel.x += (m_vel.x * friction - m_vel.x) * dt;
-    // gravity
-    m_vel.y += gravity * dt;
-    m_vel.y = std::min(m_vel.y, 8.0f); // plz don't fall through blocks
+void EntityManager::simulate(const float dt, World* world, Player* player, Blaster* blaster, const Rectangle& camera, EventQueue& events)
+{
+    m_particles.setView(camera);
+    m_particles.update(dt, world);
 
-    // frame movement = velocity + offset (knockback)
-    vec2<float> movement{m_vel.x * dt + m_offset.x * dt, m_vel.y * dt + m_offset.y * dt};
+    const std::vector<Bullet*>& bullets {blaster->getBullets()};
+    const BlasterStats* stats {&blaster->stats};
 
-    // 1. Horizontal movement
-    m_pos.x += movement.x;
+    // one search for everyone, only redone when the player changes cell or the terrain changes
+    m_flowField.update(world, player->getRect());
 
-    std::array<Rectangle, 9> rects{};
-    world->getTilesAroundPos(getCenter(), rects);
-    for (const Rectangle& rect : rects)
+    // the oldest enemies go for the player, everyone else wanders until they see them. spawn order only
+    // ever shrinks from the front, so only the first few need to be touched
+    constexpr std::size_t numAttackers {15};
+    for (std::size_t i{0}; i < std::min(m_order.size(), numAttackers + 1); ++i)
     {
-        if (CheckCollisionRecs(rect, getRect()))
-        {
-            if (movement.x < 0.0f)
-            {
-                m_pos.x = rect.x + rect.width;
-            } else {
-                m_pos.x = rect.x - m_dimensions.x;
-            }
-            m_vel.x = 0.0f;
-        }
+        EnemyPool& pool {m_pools[static_cast<std::size_t>(m_order[i].type)]};
+        const std::size_t index {pool.indexOf(m_order[i])};
+        pool.wandering[index] = i > numAttackers;
+        pool.attacking[index] = i < numAttackers;
     }
 
-    // keep entity in level
-    if (m_pos.x < 0.0f)
-    {
-        m_pos.x = 0.0f;
-        m_vel.x = 0.0f;
-    } else if (m_pos.x + m_dimensions.x > CST::LEVEL_WIDTH * CST::CHUNK_SIZE * CST::TILE_SIZE)
+    for (std::size_t type{0}; type < NUM_ENEMY_TYPES; ++type)
     {
-        m_pos.x = CST::LEVEL_WIDTH * CST::CHUNK_SIZE * CST::TILE_SIZE - m_dimensions.x;
+        Enemies::update(m_pools[type], *m_anims, dt, world, player, &m_flowField, camera, events, &m_jobs);
     }
 
-    // 2. Vertical movement
-    m_pos.y += movement.y;
-
-    // same for y motion
-    for (const Rectangle& rect : rects)
+    // broadphase, bullets only test the enemies in the cells they touch
+    m_grid.reset(world->getPixelWidth(), world->getPixelHeight());
+    for (std::size_t type{0}; type < NUM_ENEMY_TYPES; ++type)
     {
-        if (CheckCollisionRecs(rect, getRect()))
+        for (std::size_t i{0}; i < m_pools[type].size(); ++i)
         {
-            if (movement.y < 0.0f)
-            {
-                m_pos.y = rect.y + rect.height;
-            } else {
-                m_pos.y = rect.y - m_dimensions.y;
-                m_falling = 0.0f;
-            }
-            m_vel.y = 0.0f;
+            m_grid.add(Enemies::getRect(m_pools[type], i), packEnemy(type, i));
         }
     }
+    m_grid.build();
 
-    // keep player in level
-    if (static_cast<int>(m_pos.y) + m_dimensions.y > CST::LEVEL_HEIGHT * CST::CHUNK_SIZE * CST::TILE_SIZE)
+    // handle bullet collisions
+    for (Bullet* bullet : bullets)
     {
-        m_pos.y = CST::LEVEL_HEIGHT * CST::CHUNK_SIZE * CST::TILE_SIZE - m_dimensions.y;
-    }
+        const vec2<float> tip {bullet->pos.x + bullet->dir.x * stats->halfLength, bullet->pos.y + bullet->dir.y * stats->halfLength};
+        const Rectangle range {tip.x - stats->bulletRange * 0.5f, tip.y - stats->bulletRange * 0.5f, stats->bulletRange, stats->bulletRange};
+        m_grid.query(range, [&](const std::uint32_t id)
+        {
+            EnemyPool& pool {m_pools[id >> ENEMY_INDEX_BITS]};
+            const std::size_t i {id & ENEMY_INDEX_MASK};
 
-    // update offset
-    if (m_offset.x > 0.f)
-    {
-        m_offset.x = std::max(0.f, m_offset.x - offsetDecay * dt);
-    } else if (m_offset.x < 0.f) {
-        m_offset.x = std::min(0.f, m_offset.x + offsetDecay * dt);
-    }
+            // knockback enemy
+            pool.bodies[i].offset = {bullet->dir.x * stats->knockBack, bullet->dir.y * stats->knockBack};
+            // damage enemy and get rid of bullet
+            bullet->kill = true;
+            Enemies::damage(pool, i, stats->damage);
 
-    if (m_offset.y > 0.f)
-    {
-        m_offset.y = std::max(0.f, m_offset.y - offsetDecay * dt);
-    } else if (m_offset.x < 0.f) {
-        m_offset.y = std::min(0.f, m_offset.y + offsetDecay * dt);
+            events.push(GameEvent{GameEventType::HIT, tip, Enemies::getCenter(pool, i)});
+        });
     }
-}
-
-void Entity::damage(const float amount)
-{
-    m_health -= amount;
-    m_recovery = 0.0f;
-    m_attacking = true;
-}
-
-void Entity::render(const vec2<int>& scroll)
-{
-    DrawRectangle(static_cast<int>(getRect().x) - scroll.x, static_cast<int>(getRect().y) - scroll.y, m_dimensions.x, m_dimensions.y, RED);
-}
-
-// --------- Entity Manager --------- //
-EntityManager::EntityManager()
-{
-}
-
-EntityManager::~EntityManager()
-{
-    free();
-}
-
-void EntityManager::init(AssetManager* assets)
-{
-    m_sparkManager = new SparkManager{assets};
-    m_flameManager = new FlameManager{assets};
-    m_cinderManager = new CinderManager{assets};
-    m_lightTex = assets->getTexture("light");
-    m_assets = assets;
-}
-
-void EntityManager::update(const float dt, World* world, Player* player, const vec2<int>& scroll, Blaster* blaster, float& screenShake, float& coins, float& slomo)
-{
-    m_smoke.update(dt, scroll);
-    m_sparkManager->update(dt, scroll);
-    m_knockback.update(dt, scroll, world);
-    m_cinderManager->update(dt, scroll, world);
-    m_flameManager->update(dt, scroll);
-    m_shockwaves.update(dt, scroll);
 
-    const std::vector<Bullet*>& bullets {blaster->getBullets()};
-    const BlasterStats* stats {&blaster->stats};
-
-    constexpr unsigned int numAttackers {15};
-    for (std::size_t i{0}; i < m_entities.size(); ++i)
+    bool killed {false};
+    for (std::size_t type{0}; type < NUM_ENEMY_TYPES; ++type)
     {
-        m_entities[i]->setWandering(i > numAttackers);
-        m_entities[i]->setAttacking(i < numAttackers);
-        float health {player->getHealth()};
-        m_entities[i]->update(dt, world, player, screenShake);
-        if (player->getHealth() < health)
-        {
-            PlaySound(*m_assets->getSound("player_hit"));
-        }
-
-        // handle bullet collisions
-        for (Bullet* bullet : bullets)
+        EnemyPool& pool {m_pools[type]};
+        for (std::size_t i{0}; i < pool.size();)
         {
-            // check if bullet collided
-            if (CheckCollisionRecs({
-                bullet->pos.x + std::cos(bullet->angle) * stats->halfLength - stats->bulletRange * 0.5f,
-                bullet->pos.y + std::sin(bullet->angle) * stats->halfLength - stats->bulletRange * 0.5f,
-                stats->bulletRange,
-                stats->bulletRange
-            }, m_entities[i]->getRect()))
+            if (pool.health[i] < 0.f)
             {
-                // vfx
-                const vec2<float> bulletPos {bullet->pos.x + std::cos(bullet->angle) * stats->halfLength, bullet->pos.y + std::sin(bullet->angle) * stats->halfLength};
-                for (int i{0}; i < static_cast<int>(Util::random() * 10.f + 20.f); ++i)
-                {
-                    m_sparkManager->addSpark(bulletPos, Util::random() * static_cast<float>(M_PI) * 2.f, Util::random() * 2.f + 1.f);
-                }
-                for (int i{0}; i < static_cast<int>(Util::random() * 20.f + 10.f); ++i)
-                {
-                    const float angle{Util::random() * static_cast<float>(M_PI) * 2.f};
-                    const float intensity{Util::random() * 3.f + 2.f};
-                    constexpr std::array<Color, 3> colors{Color{58, 92, 133, 255}, Color{17, 131, 55, 255}, Color{151, 219, 210, 255}};
-                    m_knockback.addParticle(bulletPos, {std::cos(angle) * intensity, std::sin(angle) * intensity}, Util::pickRandom<Color, 3>(colors.data()));
-                }
-                for (int i{0}; i < static_cast<int>(Util::random() * 16.f + 10.f); ++i)
-                {
-                    const float angle{Util::random() * static_cast<float>(M_PI) * 2.f};
-                    const float intensity{Util::random() * 2.f + 1.f};
-                    m_smoke.addSmoke(bulletPos, {std::cos(angle) * intensity, std::sin(angle) * intensity - 1.f});
-                }
-                for (int i{0}; i < static_cast<int>(Util::random() * 16.f + 10.f); ++i)
-                {
-                    const float angle{Util::random() * static_cast<float>(M_PI) * 2.f};
-                    const float intensity{Util::random() * 2.f + 2.f};
-                    m_smoke.addSmoke(bulletPos, {std::cos(angle) * intensity, std::sin(angle) * intensity - 1.f});
-                }
-                // knockback enemy
-                m_entities[i]->setOffset({std::cos(bullet->angle) * stats->knockBack, std::sin(bullet->angle) * stats->knockBack});
-                // damage enemy and get rid of bullet
-                bullet->kill = true;
-                m_entities[i]->damage(stats->damage);
-
-                screenShake = std::max(screenShake, 8.f);
-                slomo = std::min(slomo, 0.9f);
-                m_lights.emplace_back(new EntityLight{40.f, 0.5f, m_entities[i]->getCenter()});
-                PlaySound(*m_assets->getSound("hit"));
+                const vec2<float> center {Enemies::getCenter(pool, i)};
+                events.push(GameEvent{GameEventType::KILL, center});
+                events.push(GameEvent{GameEventType::COIN_GAIN, center, {}, Util::random() * 10.f + 30.f});
+                pool.remove(i);
+                killed = true;
+                // the last enemy was moved into i, look at it next
+                continue;
             }
-        }
-
-        vec2<float> center {m_entities[i]->getCenter()};
-        if (m_entities[i]->getKill())
-        {
-            for (int i{0}; i < static_cast<int>(Util::random() * 20.f + 20.f); ++i)
-            {
-                m_sparkManager->addSpark(center, Util::random() * static_cast<float>(M_PI) * 2.f, Util::random() * 3.f + 1.f);
-            }
-            for (int i{0}; i < static_cast<int>(Util::random() * 20.f + 10.f); ++i)
-            {
-                const float angle{Util::random() * static_cast<float>(M_PI) * 2.f};
-                const float intensity{Util::random() * 6.f + 4.f};
-                constexpr std::array<Color, 3> colors{Color{58, 92, 133, 255}, Color{17, 131, 55, 255}, Color{151, 219, 210, 255}};
-                m_knockback.addParticle(center, {std::cos(angle) * intensity, std::sin(angle) * intensity * 3.f}, Util::pickRandom<Color, 3>(colors.data()));
-            }
-            for (int i{0}; i < static_cast<int>(Util::random() * 20.f + 17.f); ++i)
-            {
-                const float angle{Util::random() * static_cast<float>(M_PI) * 2.f};
-                const float intensity{Util::random() * 3.f + 1.f};
-                m_smoke.addSmoke(center, {std::cos(angle) * intensity, std::sin(angle) * intensity - 1.f});
-            }
-            for (int i{0}; i < static_cast<int>(Util::random() * 20.f + 20.f); ++i)
-            {
-                const float angle{Util::random() * static_cast<float>(M_PI) * 2.f};
-                const float intensity{Util::random() * 2.f + 1.f};
-                constexpr std::array<Color, 5> colors{Color{255, 253, 240, 255}, Color{248, 153, 58, 255}, Color{180, 35, 19, 255}, Color{244, 104, 11, 255}, Color{254, 181, 139, 255}};
-                m_cinderManager->addParticle(center, {std::cos(angle) * intensity * 0.5f, std::sin(angle) * intensity * 1.5f}, Util::pickRandom<Color, 5>(colors.data()));
-            }
-            m_shockwaves.addShockwave(center, 24.f);
-            m_flameManager->explode(center, 1.f);
-            delete m_entities[i];
-            m_entities[i] = nullptr;
-            coins += Util::random() * 10.f + 30.f;
-            slomo = std::min(slomo, 0.5f);
-            screenShake = std::max(screenShake, 16.f);
-            m_lights.emplace_back(new EntityLight{50.f, 0.1f, center});
-            PlaySound(*m_assets->getSound("explosion"));
-        } else {
-            m_entities[i]->render(scroll);
+            ++i;
         }
     }
 
-    // clear deleted entities
-    m_entities.erase(std::remove_if(m_entities.begin(), m_entities.end(), [](Entity* entity)
-    {
-        return entity == nullptr;
-    }), m_entities.end());
-
-    for (std::size_t i{0}; i < m_lights.size(); ++i)
+    // forget the dead in spawn order
+    if (killed)
     {
-        EntityLight* l{m_lights[i]};
-        l->scale -= l->decay * dt;
-        if (l->scale <= 0.0f)
+        m_order.erase(std::remove_if(m_order.begin(), m_order.end(), [this](const EnemyHandle& handle)
         {
-            delete m_lights[i];
-            m_lights[i] = nullptr;
-        }
+            return !isAlive(handle);
+        }), m_order.end());
     }
 
-    m_lights.erase(std::remove_if(m_lights.begin(), m_lights.end(), [](EntityLight* l)
+    for (EntityLight& l : m_lights)
     {
-        return l == nullptr;
-    }), m_lights.end());
-}
-
-void EntityManager::renderLighting(const vec2<int>& scroll)
-{
-    BeginBlendMode(BLEND_ADD_COLORS);
-    for (std::size_t i{0}; i < m_entities.size(); ++i)
-    {
-        DrawTexturePro(*m_lightTex, {0, 0, static_cast<float>(m_lightTex->width), static_cast<float>(m_lightTex->height)},
-            {m_entities[i]->getCenter().x - static_cast<float>(scroll.x) - std::min(50.f, m_entities[i]->getTimer()), m_entities[i]->getCenter().y - static_cast<float>(scroll.y) - std::min(50.f, m_entities[i]->getTimer()), std::min(50.f, m_entities[i]->getTimer()) * 2, std::min(50.f, m_entities[i]->getTimer()) * 2}, {0, 0}, 0, WHITE
-        );
+        l.scale -= l.decay * dt;
     }
-    
-    for (std::size_t i{0}; i < m_lights.size(); ++i)
+
+    m_lights.erase(std::remove_if(m_lights.begin(), m_lights.end(), [](const EntityLight& l)
     {
-        EntityLight* l{m_lights[i]};
-        DrawTexturePro(*m_lightTex, {0, 0, static_cast<float>(m_lightTex->width), static_cast<float>(m_lightTex->height)},
-            {l->pos.x - static_cast<float>(scroll.x) - l->scale, l->pos.y - static_cast<float>(scroll.y) - l->scale, l->scale * 2, l->scale * 2}, {0, 0}, 0, WHITE
-        );
-        
-    }
-    EndBlendMode();
+        return l.scale <= 0.0f;
+    }), m_lights.end());
 }
 
-void EntityManager::addEntity(EnemyType type, const vec2<float>& pos, AssetManager* assets)
+void EntityManager::handleEvents(const std::vector<GameEvent>& events)
 {
-    switch (type)
+    for (const GameEvent& event : events)
     {
-        case EnemyType::BLOBBO:
-            { // NOTE: scope fixes jump to case label error
-                Blobbo* blobbo {new Blobbo{pos}};
-                blobbo->init(assets);
-                m_entities.push_back(blobbo);
+        switch (event.type)
+        {
+            case GameEventType::HIT:
+                spawnHitVfx(event.pos);
+                m_lights.push_back(EntityLight{40.f, 0.5f, event.target});
                 break;
-            }
-        case EnemyType::PENGUIN:
-            {
-                Penguin* penguin {new Penguin{pos}};
-                penguin->init(assets);
-                m_entities.push_back(penguin);
-                return;
-            }
-        default:
-            { // "" ""
-                Entity* entity {new Entity{pos, {10, 10}, "dummy"}};
-                entity->init(assets);
-                m_entities.push_back(entity);
+            case GameEventType::KILL:
+                spawnKillVfx(event.pos);
+                m_lights.push_back(EntityLight{50.f, 0.1f, event.pos});
                 break;
-            }
+            default:
+                break;
+        }
     }
 }
 
-void EntityManager::free()
+void EntityManager::spawnHitVfx(const vec2<float>& tip)
 {
-    for (std::size_t i{0}; i < m_entities.size(); ++i)
+    if (!m_particles.shouldEmit(tip))
     {
-        delete m_entities[i];
-        m_entities[i] = nullptr;
+        return;
     }
-    m_entities.clear();
-    
-    // free vfx managers
-    delete m_sparkManager;
-    m_sparkManager = nullptr;
-    delete m_flameManager;
-    m_flameManager = nullptr;
-    delete m_cinderManager;
-    m_cinderManager = nullptr;
-
-    for (std::size_t l{0}; l < m_lights.size(); ++l)
+    for (int i{0}; i < m_particles.emitCount(PARTICLE_SPARK, Util::random() * 10.f + 20.f); ++i)
     {
-        delete m_lights[l];
+        m_particles.addSpark(tip, Util::random() * static_cast<float>(M_PI) * 2.f, Util::random() * 2.f + 1.f);
     }
-    m_lights.clear();
-}
-
-// --------- Blobbo --------- //
-
-Blobbo::Blobbo(const vec2<float>& pos)
- : Entity{pos, {6, 7}, "blobbo"}
-{
-}
-
-Blobbo::~Blobbo()
-{
-    delete m_idleAnim;
-    delete m_runAnim;
-    delete m_attackAnim;
-    delete m_hurt;
-    delete m_damage;
-}
-
-void Blobbo::init(AssetManager* assets)
-{
-    m_idleAnim = new Anim{8, 8, 5, 0.2, true, assets->getTexture("blobbo/idle")};
-    m_runAnim = new Anim{8, 8, 4, 0.2, true, assets->getTexture("blobbo/run")};
-    m_attackAnim = new Anim{8, 8, 5, 0.5, true, assets->getTexture("blobbo/attack")};
-    m_hurt = new Anim{8, 8, 1, 0.1, true, assets->getTexture("blobbo/hurt")};
-    m_damage = new Anim{8, 8, 1, 0.1, true, assets->getTexture("blobbo/damage")};
-
-    m_anim = m_idleAnim;
-
-    // bit of randomness
-    m_speed = Util::random() * 0.3f + 0.1f;
-}
-
-void Blobbo::update(const float dt, World* world, Player* player, float& screenShake)
-{
-    // handle animations
-    handleAnimations(dt);
-
-    // basic movement
-
-    m_walk += dt;
-    if (!m_wandering || m_attacking || (std::abs(player->getCenter().x - m_pos.x) < CST::TILE_SIZE * 2 && std::abs(player->getCenter().y - m_pos.y) < CST::TILE_SIZE * 2))
+    for (int i{0}; i < m_particles.emitCount(PARTICLE_KNOCKBACK, Util::random() * 20.f + 10.f); ++i)
     {
-        if (std::abs(player->getPos().x - m_pos.x) < 1920.f)
-        {
-            if (player->getPos().x > m_pos.x + 5.f)
-            {
-                m_vel.x += m_speed * dt * 1.1f;
-                m_flipped = false;
-            } else if (player->getPos().x < m_pos.x - 5.f)
-            {
-                m_vel.x -= m_speed * dt * 1.1f;
-                m_flipped = true;
-            }
-        }
-        if (CheckCollisionRecs(player->getRect(), getRect()))
-        {
-            player->damage(m_danger, screenShake);
-        }
-    } else {
-        if (m_walk > m_walkTarget)
-        {
-            m_walk = 0.0f;
-            m_direction = (Util::random() > 0.5f) ? -1 : 1;
-            m_walking = !m_walking;
-            m_walkTarget = m_walking ? (Util::random() * 100 + 100.f) : (Util::random() * 60.f + 20.f);
-        }
-
-        if (m_walking)
-        {
-            m_vel.x += m_speed * static_cast<float>(m_direction);
-        } else {
-            m_vel.x += (m_vel.x * 0.1f - m_vel.x) * dt;
-        }
-
-        m_flipped = m_direction < 0;
+        const float angle{Util::random() * static_cast<float>(M_PI) * 2.f};
+        const float intensity{Util::random() * 3.f + 2.f};
+        constexpr std::array<Color, 3> colors{Color{58, 92, 133, 255}, Color{17, 131, 55, 255}, Color{151, 219, 210, 255}};
+        m_particles.addKnockback(tip, {std::cos(angle) * intensity, std::sin(angle) * intensity}, Util::pickRandom<Color, 3>(colors.data()));
     }
-
-    if (Util::random() < (m_attacking ? 0.1 : 0.05) * dt)
+    for (int i{0}; i < m_particles.emitCount(PARTICLE_SMOKE, Util::random() * 16.f + 10.f); ++i)
     {
-        if (m_falling < 3.0f)
-        {
-            m_vel.y = -2.f;
-            m_falling = 4.0f;
-        }
+        const float angle{Util::random() * static_cast<float>(M_PI) * 2.f};
+        const float intensity{Util::random() * 2.f + 1.f};
+        m_particles.addSmoke(tip, {std::cos(angle) * intensity, std::sin(angle) * intensity - 1.f});
     }
-
-    // handle beef with player
-    if (player->getVel().y > 0.2f)
+    for (int i{0}; i < m_particles.emitCount(PARTICLE_SMOKE, Util::random() * 16.f + 10.f); ++i)
     {
-        if (CheckCollisionRecs(player->getRect(), getRect()) && m_vel.y < 1.0f)
-        {
-            player->setVelY(-4.f);
-        }
+        const float angle{Util::random() * static_cast<float>(M_PI) * 2.f};
+        const float intensity{Util::random() * 2.f + 2.f};
+        m_particles.addSmoke(tip, {std::cos(angle) * intensity, std::sin(angle) * intensity - 1.f});
     }
-
-    // update physics
-    Entity::update(dt, world, player, screenShake);
 }
 
-void Blobbo::render(const vec2<int>& scroll)
+void EntityManager::spawnKillVfx(const vec2<float>& center)
 {
-    m_anim->render({m_pos.x - 1.0f, m_pos.y - 1.0f}, scroll);
-    m_anim->setFlipped(m_flipped);
-}
-
-void Blobbo::handleAnimations(const float dt)
-{
-    if (m_falling > 3.0f)
+    if (!m_particles.shouldEmit(center))
     {
-        m_anim = m_runAnim;
-    } else if (std::abs(m_vel.x) > 0.1f)
+        return;
+    }
+    for (int i{0}; i < m_particles.emitCount(PARTICLE_SPARK, Util::random() * 20.f + 20.f); ++i)
     {
-        m_anim = m_runAnim;
-    } else {
-        m_anim = m_idleAnim;
+        m_particles.addSpark(center, Util::random() * static_cast<float>(M_PI) * 2.f, Util::random() * 3.f + 1.f);
     }
-
-    if (m_attacking)
+    for (int i{0}; i < m_particles.emitCount(PARTICLE_KNOCKBACK, Util::random() * 20.f + 10.f); ++i)
     {
-        m_anim = m_attackAnim;
+        const float angle{Util::random() * static_cast<float>(M_PI) * 2.f};
+        const float intensity{Util::random() * 6.f + 4.f};
+        constexpr std::array<Color, 3> colors{Color{58, 92, 133, 255}, Color{17, 131, 55, 255}, Color{151, 219, 210, 255}};
+        m_particles.addKnockback(center, {std::cos(angle) * intensity, std::sin(angle) * intensity * 3.f}, Util::pickRandom<Color, 3>(colors.data()));
     }
-
-    if (!getRecovered())
+    for (int i{0}; i < m_particles.emitCount(PARTICLE_SMOKE, Util::random() * 20.f + 17.f); ++i)
     {
-        m_anim = m_damage;
+        const float angle{Util::random() * static_cast<float>(M_PI) * 2.f};
+        const float intensity{Util::random() * 3.f + 1.f};
+        m_particles.addSmoke(center, {std::cos(angle) * intensity, std::sin(angle) * intensity - 1.f});
     }
-    m_anim->tick(dt);
-}
-
-Penguin::Penguin(const vec2<float>& pos)
- : Entity{pos, {5, 8}, "penguin"}
-{
+    for (int i{0}; i < m_particles.emitCount(PARTICLE_CINDER, Util::random() * 20.f + 20.f); ++i)
+    {
+        const float angle{Util::random() * static_cast<float>(M_PI) * 2.f};
+        const float intensity{Util::random() * 2.f + 1.f};
+        constexpr std::array<Color, 5> colors{Color{255, 253, 240, 255}, Color{248, 153, 58, 255}, Color{180, 35, 19, 255}, Color{244, 104, 11, 255}, Color{254, 181, 139, 255}};
+        m_particles.addCinder(center, {std::cos(angle) * intensity * 0.5f, std::sin(angle) * intensity * 1.5f}, Util::pickRandom<Color, 5>(colors.data()));
+    }
+    m_particles.addShockwave(center, 24.f);
+    m_particles.explode(center, 1.f);
 }
 
-Penguin::~Penguin()
+void EntityManager::governParticles(const float dt, const float frameMs)
 {
-    delete m_idleAnim;
-    delete m_runAnim;
-    delete m_damage;
+    m_particles.govern(dt, frameMs);
 }
 
-void Penguin::init(AssetManager* assets)
+void EntityManager::render(const Rectangle& view) const
 {
-    m_idleAnim = new Anim{5, 8, 5, 0.15f, true, assets->getTexture("penguin/idle")};
-    m_runAnim = new Anim{5, 8, 4, 0.2f, true, assets->getTexture("penguin/run")};
-    m_damage = new Anim{5, 8, 1, 0.1f, true, assets->getTexture("penguin/damage")};
+    // same layering as before the split: vfx under the enemies
+    m_particles.render(view);
 
-    m_anim = m_idleAnim;
-
-    m_speed = Util::random() * 0.3f + 0.1f;
+    for (std::size_t type{0}; type < NUM_ENEMY_TYPES; ++type)
+    {
+        Enemies::render(m_pools[type], m_kinds[type], *m_anims, view);
+    }
 }
 
-void Penguin::update(const float dt, World* world, Player* player, float& screenShake)
+void EntityManager::renderLighting(const Rectangle& view) const
 {
-    // handle animations
-    handleAnimations(dt);
-
-    // basic movement
-
-    m_walk += dt;
-    if (!m_wandering || m_attacking || (std::abs(player->getCenter().x - m_pos.x) < CST::TILE_SIZE * 2 && std::abs(player->getCenter().y - m_pos.y) < CST::TILE_SIZE * 2))
+    const vec2<float> scroll {view.x, view.y};
+    BeginBlendMode(BLEND_ADD_COLORS);
+    for (const EnemyPool& pool : m_pools)
     {
-        if (std::abs(player->getPos().x - m_pos.x) < 1920.f)
+        for (std::size_t i{0}; i < pool.size(); ++i)
         {
-            if (player->getPos().x > m_pos.x + 5.f)
-            {
-                m_vel.x += m_speed * dt * 1.1f;
-                m_flipped = false;
-            } else if (player->getPos().x < m_pos.x - 5.f)
+            const float radius {std::min(50.f, pool.timer[i])};
+            const vec2<float> center {Enemies::getCenter(pool, i)};
+            const Rectangle dest {center.x - radius, center.y - radius, radius * 2, radius * 2};
+            if (Util::inView(view, dest))
             {
-                m_vel.x -= m_speed * dt * 1.1f;
-                m_flipped = true;
+                DrawTexturePro(*m_lightTex, {0, 0, static_cast<float>(m_lightTex->width), static_cast<float>(m_lightTex->height)},
+                    {dest.x - scroll.x, dest.y - scroll.y, dest.width, dest.height}, {0, 0}, 0, WHITE
+                );
             }
         }
-        if (CheckCollisionRecs(player->getRect(), getRect()))
-        {
-            player->damage(m_danger, screenShake);
-        }
-    } else {
-        if (m_walk > m_walkTarget)
-        {
-            m_walk = 0.0f;
-            m_direction = (Util::random() > 0.5f) ? -1 : 1;
-            m_walking = !m_walking;
-            m_walkTarget = m_walking ? (Util::random() * 100 + 100.f) : (Util::random() * 60.f + 20.f);
-        }
-
-        if (m_walking)
+    }
+    
+    for (const EntityLight& l : m_lights)
+    {
+        const Rectangle dest {l.pos.x - l.scale, l.pos.y - l.scale, l.scale * 2, l.scale * 2};
+        if (Util::inView(view, dest))
         {
-            m_vel.x += m_speed * static_cast<float>(m_direction);
-        } else {
-            m_vel.x += (m_vel.x * 0.1f - m_vel.x) * dt;
+            DrawTexturePro(*m_lightTex, {0, 0, static_cast<float>(m_lightTex->width), static_cast<float>(m_lightTex->height)},
+                {dest.x - scroll.x, dest.y - scroll.y, dest.width, dest.height}, {0, 0}, 0, WHITE
+            );
         }
+    }
+    EndBlendMode();
+}
 
-        m_flipped = m_direction < 0;
+EnemyHandle EntityManager::addEntity(const EnemyType type, const vec2<float>& pos)
+{
+    if (type == EnemyType::NONE)
+    {
+        std::cout << "Can't spawn an enemy of type NONE!\n";
+        return EnemyHandle{};
     }
+    const std::size_t index {static_cast<std::size_t>(type)};
+    const EnemyHandle handle {m_pools[index].add(m_kinds[index], pos)};
+    // pool's full
+    if (handle.type == EnemyType::NONE)
+    {
+        return handle;
+    }
+    m_order.push_back(handle);
+    return handle;
+}
 
-    if (Util::random() < (m_attacking ? 0.1 : 0.05) * dt)
+std::size_t EntityManager::despawnStragglers(const vec2<float>& center, const float distance, const std::size_t max)
+{
+    // newest first, the oldest ones are the attackers
+    std::size_t removed {0};
+    for (std::size_t i{m_order.size()}; i > 0 && removed < max; --i)
     {
-        if (m_falling < 3.0f)
+        EnemyPool& pool {m_pools[static_cast<std::size_t>(m_order[i - 1].type)]};
+        const std::size_t index {pool.indexOf(m_order[i - 1])};
+        const vec2<float> pos {Enemies::getCenter(pool, index)};
+        const float dx {pos.x - center.x};
+        const float dy {pos.y - center.y};
+        if (pool.wandering[index] && dx * dx + dy * dy > distance * distance)
         {
-            m_vel.y = -2.f;
-            m_falling = 4.0f;
+            pool.remove(index);
+            ++removed;
         }
     }
 
-    // handle beef with player
-    if (player->getVel().y > 0.2f)
+    if (removed > 0)
     {
-        if (CheckCollisionRecs(player->getRect(), getRect()) && m_vel.y < 1.0f)
+        m_order.erase(std::remove_if(m_order.begin(), m_order.end(), [this](const EnemyHandle& handle)
         {
-            player->setVelY(-4.f);
-        }
+            return !isAlive(handle);
+        }), m_order.end());
     }
-
-    // update physics
-    Entity::update(dt, world, player, screenShake);
+    return removed;
 }
 
-void Penguin::render(const vec2<int>& scroll)
+bool EntityManager::isAlive(const EnemyHandle& handle) const
 {
-    m_anim->render(m_pos, scroll);
-    m_anim->setFlipped(m_flipped);
+    return handle.type != EnemyType::NONE && m_pools[static_cast<std::size_t>(handle.type)].isValid(handle);
 }
 
-void Penguin::handleAnimations(const float dt)
+void EntityManager::free()
 {
-    if (m_falling > 3.0f)
-    {
-        m_anim = m_runAnim;
-    } else if (std::abs(m_vel.x) > 0.1f)
+    for (EnemyPool& pool : m_pools)
     {
-        m_anim = m_runAnim;
-    } else {
-        m_anim = m_idleAnim;
+        pool.clear();
     }
+    m_order.clear();
 
-    if (!getRecovered())
-    {
-        m_anim = m_damage;
-    }
-    m_anim->tick(dt);
-}
\ No newline at end of file
+    m_particles.clear();
+
+    m_lights.clear();
+}
@@ -5,104 +5,23 @@
 
 #include "vec2.hpp"
 #include "tiles.hpp"
+#include "physics.hpp"
+#include "navigation.hpp"
+#include "enemies.hpp"
+#include "spatialgrid.hpp"
+#include "jobs.hpp"
+#include "events.hpp"
 #include "assets.hpp"
 #include "anim.hpp"
 #include "player.hpp"
 #include "blasters.hpp"
 #include "sparks.hpp"
 #include "particles.hpp"
+#include "constants.hpp"
 
-#include <string>
-
-enum class EnemyType
-{
-    BLOBBO,
-    PENGUIN,
-    NONE
-};
-
-class Entity
-{
-public:
-    Entity(const vec2<float>& m_pos, const vec2<int>& m_dimensions, const std::string& name);
-
-    // initialize animations or something
-    virtual void init(AssetManager* assets);
-    // handle physics
-    virtual void update(float dt, World* world, Player* player, float& screenShake);
-    // draw entity
-    virtual void render(const vec2<int>& scroll);
-
-    // getters
-    [[nodiscard]] vec2<float> getPos() const {return m_pos;}
-    [[nodiscard]] vec2<int> getDimensions() const {return m_dimensions;}
-    [[nodiscard]] std::string_view getName() const {return m_name;}
-
-    [[nodiscard]] vec2<float> getVel() const {return m_vel;}
-    [[nodiscard]] float getFalling() const {return m_falling;}
-
-    [[nodiscard]] virtual Rectangle getRect() const
-    {
-        return Rectangle {
-            m_pos.x, m_pos.y,
-            static_cast<float>(m_dimensions.x),
-            static_cast<float>(m_dimensions.y)
-        };
-    }
-
-    [[nodiscard]] vec2<float> getCenter() const
-    {
-        return vec2<float>{m_pos.x + static_cast<float>(m_dimensions.x) / 2.0f, m_pos.y + static_cast<float>(m_dimensions.y) / 2.0f};
-    }
-
-    void damage(float amount);
-
-    [[nodiscard]] float getHealth() const {return m_health;}
-    [[nodiscard]] float getMaxHealth() const {return m_maxHealth;}
-    [[nodiscard]] bool getKill() const {return m_health < 0.f;}
-
-    void setWandering(const bool val) {m_wandering = val;}
-    [[nodiscard]] bool getWandering() const {return m_wandering;}
-
-    [[nodiscard]] float getRecoveryTime() const {return m_recoveryTime;}
-    [[nodiscard]] float getRevovery() const {return m_recovery;}
-    [[nodiscard]] bool getRecovered() const {
-        return m_recoveryTime < m_recovery;
-    }
-
-    void setAttacking(const bool val) {m_attacking = val;}
-    [[nodiscard]] bool getAttacking() const {return m_attacking;}
-
-    void setOffsetX(const float val) {m_offset.x = val;}
-    void setOffsetY(const float val) {m_offset.y = val;}
-    void setOffset(const vec2<float>& val) {m_offset = val;}
-    [[nodiscard]] vec2<float> getOffset() {return m_offset;}
-
-    [[nodiscard]] float getDanger() const {return m_danger;}
-    [[nodiscard]] float getTimer() const {return m_timer;}
-
-protected:
-    vec2<float> m_pos;
-    vec2<int> m_dimensions;
-    std::string m_name;
-
-    vec2<float> m_vel{};
-
-    float m_falling{0.0f};
-
-    float m_health{10.f};
-    const float m_maxHealth{10.f};
-    const float m_recoveryTime {10.f};
-    float m_recovery{99.f};
-
-    bool m_wandering {false};
-    bool m_attacking{false};
-
-    vec2<float> m_offset{0.f, 0.f};
-
-    const float m_danger{3.0f}; // amount of damage enemy does
-    float m_timer{0.0f};
-};
+#include <array>
+#include <vector>
+#include <cstdint>
 
 struct EntityLight
 {
@@ -121,98 +40,63 @@ public:
 
     void free();
 
-    void update(float dt, World* world, Player* player, const vec2<int>& scroll, Blaster* blaster, float& screenShake, float& coins, float& slomo);
+    // moves enemies + vfx, resolves hits and deaths. never draws, so it can run headless or more than once a frame.
+    // anything that should be seen or heard goes into `events`. `camera` decides which enemies get a full update
+    void simulate(float dt, World* world, Player* player, Blaster* blaster, const Rectangle& camera, EventQueue& events);
 
-    void renderLighting(const vec2<int>& scroll);
+    // subscriber: hit and death particles + lights
+    void handleEvents(const std::vector<GameEvent>& events);
 
-    void addEntity(EnemyType type, const vec2<float>& pos, AssetManager* assets);
+    // frameMs is how long the last frame's simulate + render took, vfx emission is scaled to fit it
+    void governParticles(float dt, float frameMs);
 
-    [[nodiscard]] SparkManager* getSparkManager() const {return m_sparkManager;}
+    // draws enemies and vfx as they were left by the last simulate
+    void render(const Rectangle& view) const;
 
-private:
-    std::vector<Entity*> m_entities{};
+    void renderLighting(const Rectangle& view) const;
 
-    // particle vfx managers
-    SparkManager* m_sparkManager{nullptr};
-    FlameManager* m_flameManager{nullptr};
-    CinderManager* m_cinderManager{nullptr};
-    KnockbackManager m_knockback{};
-    SmokeManager m_smoke{};
-    ShockwaveManager m_shockwaves{};
-    Texture2D* m_lightTex{nullptr};
-    AssetManager* m_assets{nullptr};
+    EnemyHandle addEntity(EnemyType type, const vec2<float>& pos);
+    // removes up to `max` of the newest wanderers further than distance from center, returns how many went
+    std::size_t despawnStragglers(const vec2<float>& center, float distance, std::size_t max);
 
-    std::vector<EntityLight*> m_lights{};
-};
+    [[nodiscard]] bool isAlive(const EnemyHandle& handle) const;
+    [[nodiscard]] std::size_t getEnemyCount() const {return m_order.size();}
 
-class Blobbo : public Entity
-{
-public:
-    Blobbo(const vec2<float>& pos);
-    ~Blobbo();
-
-    virtual void init(AssetManager* assets);
-    virtual void update(float dt, World* world, Player* player, float& screenShake);
-    virtual void render(const vec2<int>& scroll);
-
-    void handleAnimations(float dt);
-
-    void setFlipped(const bool val) {m_flipped = val;}
-    [[nodiscard]] bool getFlipped() const {return m_flipped;}
+    [[nodiscard]] const ParticleEngine& getParticles() const {return m_particles;}
 
 private:
-    Anim* m_idleAnim{nullptr};
-    Anim* m_runAnim{nullptr};
-    Anim* m_damage{nullptr};
-    Anim* m_hurt{nullptr};
-    Anim* m_attackAnim{nullptr};
-
-    Anim* m_anim{nullptr};
+    void spawnHitVfx(const vec2<float>& tip);
+    void spawnKillVfx(const vec2<float>& center);
 
-    bool m_flipped{false};
+    // lights to reserve room for, more than this is fine but will allocate
+    static constexpr std::size_t MAX_LIGHTS {256};
 
-    float m_speed = 0.05f;
-
-    float m_walk{110.0f};
-    float m_walkTarget{100.f};
-    int m_direction{1};
-    bool m_walking{true};
-
-    const float m_danger{4.f};
-};
-
-class Penguin : public Entity
-{
-public:
-    Penguin(const vec2<float>& pos);
-    ~Penguin();
-
-    virtual void init(AssetManager* assets);
-    virtual void update(float dt, World* world, Player* player, float& screenShake);
-    virtual void render(const vec2<int>& scroll);
-
-    void handleAnimations(float dt);
-
-    void setFlipped(const bool val) {m_flipped = val;}
-    [[nodiscard]] bool getFlipped() const {return m_flipped;}
-
-private:
-    Anim* m_idleAnim{nullptr};
-    Anim* m_runAnim{nullptr};
-    Anim* m_damage{nullptr};
-
-    Anim* m_anim{nullptr};
-
-    bool m_flipped{false};
+    // grid ids are the enemy type in the top bits and the index in its pool below
+    static constexpr std::uint32_t ENEMY_INDEX_BITS {24};
+    static constexpr std::uint32_t ENEMY_INDEX_MASK {(1u << ENEMY_INDEX_BITS) - 1u};
+    [[nodiscard]] static std::uint32_t packEnemy(const std::size_t type, const std::size_t index)
+    {
+        return static_cast<std::uint32_t>(type) << ENEMY_INDEX_BITS | static_cast<std::uint32_t>(index);
+    }
 
-    float m_speed = 0.05f;
+    // one pool per enemy type, indexed by EnemyType
+    std::array<EnemyKind, NUM_ENEMY_TYPES> m_kinds{Enemies::makeKinds()};
+    std::array<EnemyPool, NUM_ENEMY_TYPES> m_pools{EnemyPool{EnemyType::BLOBBO, CST::MAX_ENEMIES}, EnemyPool{EnemyType::PENGUIN, CST::MAX_ENEMIES}};
+    // everyone in spawn order, the oldest ones attack
+    std::vector<EnemyHandle> m_order{};
+    // enemy boxes for the bullet checks, rebuilt every tick
+    SpatialGrid m_grid{};
+    // path to the player, shared by every enemy
+    FlowField m_flowField{};
+    // enemy updates are split across these
+    JobSystem m_jobs{};
 
-    float m_walk{110.0f};
-    float m_walkTarget{100.f};
-    int m_direction{1};
-    bool m_walking{true};
+    // particle vfx managers
+    ParticleEngine m_particles{};
+    Texture2D* m_lightTex{nullptr};
+    const AnimSet* m_anims{nullptr};
 
-    const float m_danger{4.f};
+    std::vector<EntityLight> m_lights{};
 };
 
 #endif
@@ -0,0 +1,67 @@
+#ifndef EVENTS_H
+#define EVENTS_H
+
+#include "vec2.hpp"
+
+#include <cstdint>
+#include <functional>
+#include <utility>
+#include <vector>
+
+enum class GameEventType : std::uint8_t
+{
+    HIT, // a bullet hit an enemy
+    KILL, // an enemy died
+    PLAYER_DAMAGED,
+    COIN_GAIN,
+};
+
+// something that happened during simulate. plain data, so it can be queued, coalesced or replayed
+struct GameEvent
+{
+    GameEventType type;
+    vec2<float> pos{}; // where it happened (bullet tip, enemy center)
+    vec2<float> target{}; // hit: center of the enemy that got hit
+    float amount{0.0f}; // damage taken / coins gained
+};
+
+// everything that happened in a frame, handed to each subscriber in one go instead of reacting on the spot.
+// the simulation only ever pushes, sounds, particles and camera effects all live in subscribers
+class EventQueue
+{
+public:
+    using Subscriber = std::function<void(const std::vector<GameEvent>&)>;
+
+    EventQueue()
+    {
+        m_events.reserve(MAX_EVENTS);
+    }
+
+    void push(const GameEvent& event) {m_events.push_back(event);}
+
+    void subscribe(Subscriber subscriber) {m_subscribers.push_back(std::move(subscriber));}
+
+    // give the frame's events to every subscriber in the order they subscribed, then forget them
+    void dispatch()
+    {
+        if (!m_events.empty())
+        {
+            for (const Subscriber& subscriber : m_subscribers)
+            {
+                subscriber(m_events);
+            }
+        }
+        m_events.clear();
+    }
+
+    [[nodiscard]] const std::vector<GameEvent>& getEvents() const {return m_events;}
+
+private:
+    // a busy frame, more is fine but will allocate
+    static constexpr std::size_t MAX_EVENTS {1024};
+
+    std::vector<GameEvent> m_events{};
+    std::vector<Subscriber> m_subscribers{};
+};
+
+#endif
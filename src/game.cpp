@@ -2,10 +2,13 @@
 #include "constants.hpp"
 #include "util.hpp"
 #include "buttons.hpp"
+#include "debug.hpp"
 
 #include <raylib.h>
 #include <sstream>
 #include <iostream>
+#include <iomanip>
+#include <chrono>
 
 // ------- Core game functions ------- //
 
@@ -30,7 +33,11 @@ void Game::init()
     m_player.loadAnim(&m_assets);
 
     m_entityManager.init(&m_assets);
-    m_entityManager.addEntity(EnemyType::BLOBBO, {50, 10}, &m_assets);
+    m_entityManager.addEntity(EnemyType::BLOBBO, {50, 10});
+    m_director.loadFromFile(m_wavesPath.c_str());
+
+    m_events.subscribe([this](const std::vector<GameEvent>& events) {m_entityManager.handleEvents(events);});
+    m_events.subscribe([this](const std::vector<GameEvent>& events) {handleEvents(events);});
 
     m_blaster = new Blaster{&m_player, "default",  {0.f, 1.f}};
     m_blaster->init(&m_assets);
@@ -179,36 +186,38 @@ bool Game::menu()
     return true;
 }
 
-void Game::update()
+void Game::simulate()
 {
-    // ------ Update stuff ------ //
+    const std::chrono::steady_clock::time_point start {std::chrono::steady_clock::now()};
 
     m_player.update(m_dt, &m_world);
     m_blaster->update(m_dt, &m_world);
 
     m_gameTime += m_dt;
-    m_interval = std::max(1.f, m_interval - 0.005f * m_dt);
-    m_distance = std::min(650.f, m_distance + 0.02f * m_dt);
+    m_director.update(m_dt, &m_entityManager, m_player.getCenter(), m_simulateMs);
 
-    m_timer += m_dt;
-    if (m_timer > m_interval)
-    {
-        m_timer = 0.0f;
-        m_entityManager.addEntity(Util::random() < 0.5f ? EnemyType::BLOBBO : EnemyType::PENGUIN, {Util::random() * m_distance + 10.f, -10}, &m_assets);
-        m_entityManager.addEntity(Util::random() < 0.5f ? EnemyType::BLOBBO : EnemyType::PENGUIN, {1188 - Util::random() * m_distance, -10}, &m_assets);
-    }
+    // camera follows the player
+    m_scroll.x += std::floor((m_player.getPos().x - static_cast<float>(m_width) / CST::SCR_VRATIO / 2.f - m_scroll.x) / 6) * m_dt;
+    m_scroll.y += std::floor((m_player.getPos().y - static_cast<float>(m_height) / CST::SCR_VRATIO / 2.f - m_scroll.y) / 10) * m_dt;
 
-    // -------------------------- //
-    // ------ do rendering ------  //
+    m_scroll.x = std::max(static_cast<float>(CST::TILE_SIZE), std::min(m_scroll.x, m_world.getPixelWidth()));
+    m_scroll.y = std::max(0.0f, std::min(m_scroll.y, m_world.getPixelHeight()));
 
-    ClearBackground({20, 60, 108, 0xFF});
-    // ClearBackground(BLACK);
+    m_screenShake = std::max(0.0f, m_screenShake - m_dt);
 
-    m_scroll.x += std::floor((m_player.getPos().x - static_cast<float>(m_width) / CST::SCR_VRATIO / 2.f - m_scroll.x) / 6) * m_dt;
-    m_scroll.y += std::floor((m_player.getPos().y - static_cast<float>(m_height) / CST::SCR_VRATIO / 2.f - m_scroll.y) / 10) * m_dt;
+    m_entityManager.governParticles(m_dt, m_simulateMs + m_renderMs);
+    m_entityManager.simulate(m_dt, &m_world, &m_player, m_blaster,
+        Util::getViewRect({static_cast<int>(m_scroll.x), static_cast<int>(m_scroll.y)}, m_width, m_height), m_events);
+    m_events.dispatch();
 
-    m_scroll.x = std::max(static_cast<float>(CST::TILE_SIZE), std::min(m_scroll.x, static_cast<float>(CST::TILE_SIZE * CST::CHUNK_SIZE * CST::LEVEL_WIDTH)));
-    m_scroll.y = std::max(0.0f, std::min(m_scroll.y, static_cast<float>(CST::TILE_SIZE * CST::LEVEL_WIDTH * CST::LEVEL_HEIGHT)));
+    const std::chrono::duration<float, std::milli> elapsed {std::chrono::steady_clock::now() - start};
+    m_simulateMs = elapsed.count();
+}
+
+void Game::render()
+{
+    ClearBackground({20, 60, 108, 0xFF});
+    // ClearBackground(BLACK);
 
     vec2<float> screenShakeOffset{Util::random() * m_screenShake - m_screenShake / 2.f, Util::random() * m_screenShake - m_screenShake / 2.f};
     if (!m_screenShakeEnabled)
@@ -217,23 +226,63 @@ void Game::update()
     }
     constexpr float screenShakeScale {0.5f};
     vec2<int> renderScroll {static_cast<int>(m_scroll.x + screenShakeOffset.x * screenShakeScale), static_cast<int>(m_scroll.y + screenShakeOffset.y * screenShakeScale)};
-    m_screenShake = std::max(0.0f, m_screenShake - m_dt);
-    m_world.render(renderScroll, m_width, m_height, &m_assets);
+    const Rectangle view {Util::getViewRect(renderScroll, m_width, m_height)};
+    m_world.render(view);
     DrawRectangle(0, 0, m_width, m_height, {180, 35, 19, static_cast<unsigned char>(static_cast<int>((1.f - std::min(1.f, m_player.getRecovery() / m_player.getRecoverTime())) * 100.f))});
 
     m_player.draw(renderScroll);
 
     if (m_player.getRecovery() > m_player.getRecoverTime() + 20.f)
     {
-        m_blaster->render(renderScroll);
+        m_blaster->render(view);
     }
-    m_blaster->renderBullets(renderScroll);
+    m_blaster->renderBullets(view);
 
-    m_entityManager.update(m_dt, &m_world, &m_player, renderScroll, m_blaster, m_screenShake, m_coins, m_slomo);
+    m_entityManager.render(view);
+}
 
-    // -------------------------- //
+void Game::handleEvents(const std::vector<GameEvent>& events)
+{
+    // ten hits in a frame still only play one hit sound
+    bool hit {false};
+    bool kill {false};
+    bool hurt {false};
+    for (const GameEvent& event : events)
+    {
+        switch (event.type)
+        {
+            case GameEventType::HIT:
+                m_screenShake = std::max(m_screenShake, 8.f);
+                m_slomo = std::min(m_slomo, 0.9f);
+                hit = true;
+                break;
+            case GameEventType::KILL:
+                m_screenShake = std::max(m_screenShake, 16.f);
+                m_slomo = std::min(m_slomo, 0.5f);
+                kill = true;
+                break;
+            case GameEventType::PLAYER_DAMAGED:
+                m_screenShake = std::max(m_screenShake, 12.f);
+                hurt = true;
+                break;
+            case GameEventType::COIN_GAIN:
+                m_coins += event.amount;
+                break;
+        }
+    }
 
-    checkScreenResize();
+    if (hit)
+    {
+        PlaySound(*m_assets.getSound("hit"));
+    }
+    if (kill)
+    {
+        PlaySound(*m_assets.getSound("explosion"));
+    }
+    if (hurt)
+    {
+        PlaySound(*m_assets.getSound("player_hit"));
+    }
 }
 
 void Game::run()
@@ -252,80 +301,123 @@ void Game::run()
         {
             m_coinAnim = 0.0f;
         }
-        BeginTextureMode(m_targetBuffer);
-        // render to screen buffer
+        DBG::resetFrame();
+        // page chunks around the camera in/out
+        m_world.stream(Util::getViewRect({static_cast<int>(m_scroll.x), static_cast<int>(m_scroll.y)}, m_width, m_height));
 
-        if (!m_paused && !m_shop)
+        const bool running {!m_paused && !m_shop};
+        if (running)
         {
             if (!IsWindowResized())
             {
-                // update components and do rendering stuff
-                update();
-                if (m_lastPaused < 60.f)
-                {
-                    Texture2D* playTex {m_assets.getTexture("pause")};
-                    DrawTexture(*playTex, static_cast<int>(static_cast<float>(m_width) / CST::SCR_VRATIO / 2.f - (float)playTex->width * 0.5f), static_cast<int>(static_cast<float>(m_height) / CST::SCR_VRATIO / 2.f - (float)playTex->height * 0.5f), WHITE);
-                }
-            } else {
-                checkScreenResize();
+                simulate();
             }
             handleControls();
-        } else {
-            if (!m_shop)
+        }
+
+        // only a frame that actually renders below has a render cost, so the particle governor doesn't keep
+        // throttling on the last one from before minimising
+        m_renderMs = 0.0f;
+
+        // nothing to see while minimised, keep the game going but skip every draw
+        const bool visible {!IsWindowMinimized()};
+        if (visible)
+        {
+            // (re)bake chunk textures before we start drawing into the screen buffer
+            m_world.updateRenderCache(&m_assets);
+            BeginTextureMode(m_targetBuffer);
+            // render to screen buffer
+
+            if (running)
+            {
+                if (!IsWindowResized())
+                {
+                    const std::chrono::steady_clock::time_point renderStart {std::chrono::steady_clock::now()};
+                    render();
+                    const std::chrono::duration<float, std::milli> renderTime {std::chrono::steady_clock::now() - renderStart};
+                    m_renderMs = renderTime.count();
+                    // leave the frame we just paused on clean, the play icon goes on top of it
+                    if (m_lastPaused < 60.f && !m_paused)
+                    {
+                        Texture2D* playTex {m_assets.getTexture("pause")};
+                        DrawTexture(*playTex, static_cast<int>(static_cast<float>(m_width) / CST::SCR_VRATIO / 2.f - (float)playTex->width * 0.5f), static_cast<int>(static_cast<float>(m_height) / CST::SCR_VRATIO / 2.f - (float)playTex->height * 0.5f), WHITE);
+                    }
+                }
+            } else if (!m_shop)
             {
+                // the screen buffer gets remade on resize, redraw the paused frame into it
                 if (IsWindowResized())
                 {
-                    update();
+                    render();
                 }
-                m_lastPaused = 0.0f;
                 Texture2D* playTex {m_assets.getTexture("play")};
                 DrawTexture(*playTex, static_cast<int>(static_cast<float>(m_width) / CST::SCR_VRATIO / 2.f - (float)playTex->width * 0.5f), static_cast<int>(static_cast<float>(m_height) / CST::SCR_VRATIO / 2.f - (float)playTex->height * 0.5f), WHITE);
-                if (IsKeyPressed(KEY_P))
+            }
+
+            // end rendering to screen buffer
+            EndTextureMode();
+
+            renderLights();
+        }
+
+        if (running)
+        {
+            checkScreenResize();
+        } else if (!m_shop)
+        {
+            if (IsWindowResized())
+            {
+                checkScreenResize();
+            }
+            m_lastPaused = 0.0f;
+            if (IsKeyPressed(KEY_P))
+            {
+                if (m_paused)
                 {
-                    if (m_paused)
-                    {
-                        PlayMusicStream(m_music);
-                        m_paused = false;
-                    }
+                    PlayMusicStream(m_music);
+                    m_paused = false;
                 }
             }
         }
 
-        // end rendering to screen buffer
-        EndTextureMode();
-
-        renderLights();
-
+        // still has to happen when minimised, it polls input and paces the frame
         BeginDrawing();
 
-        Texture2D* tex {m_assets.getTexture("noise")};
-        BeginShaderMode(*m_assets.getShader("screenShader"));
-        SetShaderValueTexture(*m_assets.getShader("screenShader"), GetShaderLocation(*m_assets.getShader("screenShader"), "lighting"), m_lightingBuffer.texture);
-        SetShaderValueTexture(*m_assets.getShader("screenShader"), GetShaderLocation(*m_assets.getShader("screenShader"), "noise"), *tex);
-        SetShaderValue(*m_assets.getShader("screenShader"), GetShaderLocation(*m_assets.getShader("screenShader"), "width"), &m_width, SHADER_UNIFORM_INT);
-        SetShaderValue(*m_assets.getShader("screenShader"), GetShaderLocation(*m_assets.getShader("screenShader"), "height"), &m_height, SHADER_UNIFORM_INT);
-        float time {static_cast<float>(GetTime())};
-        SetShaderValue(*m_assets.getShader("screenShader"), GetShaderLocation(*m_assets.getShader("screenShader"), "time"), &time, SHADER_UNIFORM_FLOAT);
-        SetShaderValue(*m_assets.getShader("screenShader"), GetShaderLocation(*m_assets.getShader("screenShader"), "scrollx"), &m_scroll.x, SHADER_UNIFORM_FLOAT);
-        SetShaderValue(*m_assets.getShader("screenShader"), GetShaderLocation(*m_assets.getShader("screenShader"), "scrolly"), &m_scroll.y, SHADER_UNIFORM_FLOAT);
-        SetShaderValue(*m_assets.getShader("screenShader"), GetShaderLocation(*m_assets.getShader("screenShader"), "darkness"), &m_darkness, SHADER_UNIFORM_FLOAT);
-        DrawTexturePro(m_targetBuffer.texture,
-            m_srcRect,
-            m_destRect,
-            Vector2{0, 0}, 0, WHITE);
-        EndShaderMode();
+        if (visible)
+        {
+            Texture2D* tex {m_assets.getTexture("noise")};
+            BeginShaderMode(*m_assets.getShader("screenShader"));
+            SetShaderValueTexture(*m_assets.getShader("screenShader"), GetShaderLocation(*m_assets.getShader("screenShader"), "lighting"), m_lightingBuffer.texture);
+            SetShaderValueTexture(*m_assets.getShader("screenShader"), GetShaderLocation(*m_assets.getShader("screenShader"), "noise"), *tex);
+            SetShaderValue(*m_assets.getShader("screenShader"), GetShaderLocation(*m_assets.getShader("screenShader"), "width"), &m_width, SHADER_UNIFORM_INT);
+            SetShaderValue(*m_assets.getShader("screenShader"), GetShaderLocation(*m_assets.getShader("screenShader"), "height"), &m_height, SHADER_UNIFORM_INT);
+            float time {static_cast<float>(GetTime())};
+            SetShaderValue(*m_assets.getShader("screenShader"), GetShaderLocation(*m_assets.getShader("screenShader"), "time"), &time, SHADER_UNIFORM_FLOAT);
+            SetShaderValue(*m_assets.getShader("screenShader"), GetShaderLocation(*m_assets.getShader("screenShader"), "scrollx"), &m_scroll.x, SHADER_UNIFORM_FLOAT);
+            SetShaderValue(*m_assets.getShader("screenShader"), GetShaderLocation(*m_assets.getShader("screenShader"), "scrolly"), &m_scroll.y, SHADER_UNIFORM_FLOAT);
+            SetShaderValue(*m_assets.getShader("screenShader"), GetShaderLocation(*m_assets.getShader("screenShader"), "darkness"), &m_darkness, SHADER_UNIFORM_FLOAT);
+            DrawTexturePro(m_targetBuffer.texture,
+                m_srcRect,
+                m_destRect,
+                Vector2{0, 0}, 0, WHITE);
+            EndShaderMode();
 
 #ifdef DEBUG_INFO_ENABLED
-        drawFPS();
+            drawFPS();
 #endif
 
-        if (!m_shop)
-            drawUI();
+            if (!m_shop)
+                drawUI();
+
+            if (m_shop)
+            {
+                shop();
+            }
+        }
 
         if (m_shop)
         {
             SetMusicVolume(m_music, 0.2f);
-            shop();
             m_shopFade += (1.0 - m_shopFade) * 0.25f * m_dt;
         } else {
             SetMusicVolume(m_music, m_darkness);
@@ -413,6 +505,7 @@ bool Game::death()
 void Game::close()
 {
     delete m_blaster;
+    m_world.free();
     UnloadRenderTexture(m_targetBuffer);
     UnloadRenderTexture(m_lightingBuffer);
     UnloadMusicStream(m_music);
@@ -423,11 +516,14 @@ void Game::close()
 
 void Game::reset()
 {
+    // put back the terrain the last run blew up
+    m_world.loadFromFile(m_mapPath.c_str());
     m_player.setHealth(m_player.getMaxHealth());
     m_player.setRecovery(999.f);
     m_player.setPos(m_spawnPos);
     m_entityManager.free();
     m_entityManager.init(&m_assets);
+    m_director.reset();
     m_darkness = 1.0f;
     m_coins = 0.0f;
     delete m_blaster;
@@ -469,6 +565,26 @@ void Game::drawFPS()
     ss << "FPS: " << GetFPS() << "";
 
     DrawTextEx(*m_assets.getFont("pixel"), ss.str().c_str(), {5, 5}, 20, 0, WHITE);
+
+    ss.str("");
+    ss << "World draws: " << DBG::worldDrawCalls << ", spark draws: " << DBG::sparkDrawCalls << " (blaster " << DBG::blasterSparkDrawCalls << "), cinder draws: " << DBG::cinderDrawCalls;
+    DrawTextEx(*m_assets.getFont("pixel"), ss.str().c_str(), {5, 25}, 20, 0, WHITE);
+
+    const WaveStats& waves {m_director.getStats()};
+    ss.str("");
+    ss << "Wave " << waves.wave + 1 << "/" << m_director.getWaveCount() << ", enemies: " << waves.alive << "/" << waves.cap
+        << ", sim: " << std::fixed << std::setprecision(2) << waves.simulateMs << "ms";
+    DrawTextEx(*m_assets.getFont("pixel"), ss.str().c_str(), {5, 45}, 20, 0, WHITE);
+
+    ss.str("");
+    ss << "Spawned: " << waves.spawned << ", despawned: " << waves.despawned << ", skipped: " << waves.skipped;
+    DrawTextEx(*m_assets.getFont("pixel"), ss.str().c_str(), {5, 65}, 20, 0, WHITE);
+
+    const ParticleEngine& particles {m_entityManager.getParticles()};
+    ss.str("");
+    ss << "Particles: " << particles.getCount() << "/" << particles.getLiveCap() << ", scale: " << std::setprecision(2) << particles.getScale()
+        << ", frame: " << particles.getFrameMs() << "ms, culled: " << particles.getCulled() << ", dropped: " << particles.getDropped();
+    DrawTextEx(*m_assets.getFont("pixel"), ss.str().c_str(), {5, 85}, 20, 0, WHITE);
     // DrawText(ss.str().c_str(), 5, 5, 20, WHITE);
 }
 
@@ -870,7 +986,6 @@ void Game::handleControls()
         {
             PauseMusicStream(m_music);
             m_paused = true;
-            update();
         }
     }
 
@@ -888,7 +1003,7 @@ void Game::renderLights()
     Texture2D* tex {m_assets.getTexture("light")};
     DrawTexturePro(*tex, {0, 0, static_cast<float>(tex->width), static_cast<float>(tex->height)}, {m_player.getCenter().x - 100.f - m_scroll.x, m_player.getCenter().y - 100.f - m_scroll.y, 200.f, 200.f}, {0.0f, 0.0f}, 0.0f, WHITE);
 
-    m_entityManager.renderLighting({static_cast<int>(m_scroll.x), static_cast<int>(m_scroll.y)});
+    m_entityManager.renderLighting(Util::getViewRect({static_cast<int>(m_scroll.x), static_cast<int>(m_scroll.y)}, m_width, m_height));
 
     EndTextureMode();
 }
\ No newline at end of file
@@ -8,6 +8,8 @@
 #include "player.hpp"
 #include "entities.hpp"
 #include "blasters.hpp"
+#include "events.hpp"
+#include "waves.hpp"
 
 #include <string>
 
@@ -25,8 +27,13 @@ public:
     // menu
     bool menu();
 
-    // update components
-    void update();
+    // advance the game one tick, no draw calls
+    void simulate();
+    // draw the game world into the screen buffer, reads state only
+    void render();
+
+    // subscriber: sounds, screen shake, slomo and coins
+    void handleEvents(const std::vector<GameEvent>& events);
 
     void run();
 
@@ -78,6 +85,9 @@ private:
     World m_world{};
     AssetManager m_assets{};
     EntityManager m_entityManager{};
+    // filled by simulate, drained once a tick
+    EventQueue m_events{};
+    WaveDirector m_director{};
     const vec2<float> m_spawnPos{594.f, -20.f};
     Player m_player{m_spawnPos, {7, 14}};
     Blaster* m_blaster{nullptr};
@@ -85,6 +95,7 @@ private:
 
     // random stuff
     std::string m_mapPath{"data/maps/0.json"};
+    std::string m_wavesPath{"data/waves.json"};
 
     // rendering + core
     int m_width{};
@@ -96,8 +107,11 @@ private:
 
     // deltatime
     float m_dt{1.0f};
-    float m_timer{0.0f};
     float m_slomo{1.0f};
+    // how long the last simulate took, the wave director keeps it in budget
+    float m_simulateMs{0.0f};
+    // how long the last render took, particle emission is scaled to keep simulate + render in budget
+    float m_renderMs{0.0f};
 
     bool m_paused{false};
     float m_lastPaused{0.0f};
@@ -116,8 +130,6 @@ private:
     float m_darkness{1.0f};
 
     float m_gameTime{0.0f};
-    float m_distance{50.f};
-    float m_interval{240.f};
 
     // Music
     Music m_music{};
@@ -0,0 +1,150 @@
+#include "jobs.hpp"
+
+#include <algorithm>
+
+JobSystem::JobSystem(std::size_t workers)
+{
+    if (workers == 0)
+    {
+        workers = std::max(1u, std::thread::hardware_concurrency());
+    }
+    workers = std::min(workers, MAX_WORKERS);
+
+    m_queues.reserve(workers);
+    for (std::size_t i{0}; i < workers; ++i)
+    {
+        m_queues.push_back(std::make_unique<Queue>());
+        // room for a few hundred chunks each so a frame never grows them
+        m_queues.back()->jobs.reserve(256);
+    }
+
+    // worker 0 is whoever calls parallelFor
+    m_threads.reserve(workers - 1);
+    for (std::size_t i{1}; i < workers; ++i)
+    {
+        m_threads.emplace_back(&JobSystem::workerLoop, this, i);
+    }
+}
+
+JobSystem::~JobSystem()
+{
+    {
+        const std::lock_guard<std::mutex> lock {m_wakeMutex};
+        m_quit = true;
+    }
+    m_wake.notify_all();
+    for (std::thread& thread : m_threads)
+    {
+        thread.join();
+    }
+}
+
+void JobSystem::run(Batch& batch, const std::size_t count, const std::size_t grain)
+{
+    if (count == 0)
+    {
+        return;
+    }
+    const std::size_t step {std::max<std::size_t>(1, grain)};
+    const std::size_t chunks {(count + step - 1) / step};
+
+    // nobody to share with, skip the queues
+    if (m_queues.size() == 1 || chunks == 1)
+    {
+        batch.fn(batch.ctx, 0, count, 0);
+        return;
+    }
+
+    batch.remaining = chunks;
+    for (std::size_t c{0}; c < chunks; ++c)
+    {
+        Queue& queue {*m_queues[c % m_queues.size()]};
+        const std::lock_guard<std::mutex> lock {queue.mutex};
+        queue.jobs.push_back(Job{&batch, c * step, std::min(count, (c + 1) * step)});
+    }
+    m_queued += chunks;
+
+    // taking the lock means a worker is either already waiting or will see m_queued before it waits
+    {
+        const std::lock_guard<std::mutex> lock {m_wakeMutex};
+    }
+    m_wake.notify_all();
+
+    // help out until the last chunk is finished
+    Job job {};
+    while (batch.remaining.load() > 0)
+    {
+        if (findJob(0, job))
+        {
+            execute(job, 0);
+        } else {
+            std::this_thread::yield();
+        }
+    }
+}
+
+void JobSystem::workerLoop(const std::size_t worker)
+{
+    Job job {};
+    while (true)
+    {
+        if (findJob(worker, job))
+        {
+            execute(job, worker);
+            continue;
+        }
+
+        std::unique_lock<std::mutex> lock {m_wakeMutex};
+        m_wake.wait(lock, [this] {return m_quit || m_queued.load() > 0;});
+        if (m_quit)
+        {
+            return;
+        }
+    }
+}
+
+bool JobSystem::findJob(const std::size_t worker, Job& job)
+{
+    // own queue first, newest job
+    {
+        Queue& queue {*m_queues[worker]};
+        const std::lock_guard<std::mutex> lock {queue.mutex};
+        if (queue.jobs.size() > queue.head)
+        {
+            job = queue.jobs.back();
+            queue.jobs.pop_back();
+            if (queue.jobs.size() == queue.head)
+            {
+                queue.jobs.clear();
+                queue.head = 0;
+            }
+            --m_queued;
+            return true;
+        }
+    }
+
+    // then steal the oldest job from the next queue along that has one
+    for (std::size_t i{1}; i < m_queues.size(); ++i)
+    {
+        Queue& queue {*m_queues[(worker + i) % m_queues.size()]};
+        const std::lock_guard<std::mutex> lock {queue.mutex};
+        if (queue.jobs.size() > queue.head)
+        {
+            job = queue.jobs[queue.head++];
+            if (queue.jobs.size() == queue.head)
+            {
+                queue.jobs.clear();
+                queue.head = 0;
+            }
+            --m_queued;
+            return true;
+        }
+    }
+    return false;
+}
+
+void JobSystem::execute(const Job& job, const std::size_t worker)
+{
+    job.batch->fn(job.batch->ctx, job.begin, job.end, worker);
+    --job.batch->remaining;
+}
@@ -0,0 +1,84 @@
+#ifndef JOBS_H
+#define JOBS_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+// fixed pool of worker threads for splitting a loop over many cores
+//
+// every worker has its own queue. parallelFor deals the chunks out round robin, a worker works through
+// its own queue from the back and steals from the front of the others once it runs dry, so a slow chunk
+// doesn't hold everyone up. the calling thread is worker 0 and helps until the loop is done
+class JobSystem
+{
+public:
+    // most workers a caller needs to keep per worker scratch for
+    static constexpr std::size_t MAX_WORKERS {64};
+
+    // workers counts the calling thread, 0 means one per core
+    explicit JobSystem(std::size_t workers = 0);
+    ~JobSystem();
+
+    JobSystem(const JobSystem&) = delete;
+    JobSystem& operator=(const JobSystem&) = delete;
+
+    [[nodiscard]] std::size_t getWorkerCount() const {return m_queues.size();}
+
+    // runs fn(begin, end, worker) over [0, count) in chunks of `grain`, returns once every chunk is done.
+    // worker is in [0, getWorkerCount()) and is only ever used by one chunk at a time
+    template <typename Fn>
+    void parallelFor(const std::size_t count, const std::size_t grain, Fn&& fn)
+    {
+        using F = std::remove_reference_t<Fn>;
+        Batch batch {[](void* ctx, const std::size_t begin, const std::size_t end, const std::size_t worker) {
+            (*static_cast<F*>(ctx))(begin, end, worker);
+        }, const_cast<void*>(static_cast<const void*>(&fn))};
+        run(batch, count, grain);
+    }
+
+private:
+    // one parallelFor call
+    struct Batch
+    {
+        void (*fn)(void* ctx, std::size_t begin, std::size_t end, std::size_t worker);
+        void* ctx;
+        std::atomic<std::size_t> remaining{0};
+    };
+
+    struct Job
+    {
+        Batch* batch;
+        std::size_t begin;
+        std::size_t end;
+    };
+
+    // owner pops from the back, thieves take from the front at `head`
+    struct Queue
+    {
+        std::mutex mutex{};
+        std::vector<Job> jobs{};
+        std::size_t head{0};
+    };
+
+    void run(Batch& batch, std::size_t count, std::size_t grain);
+    void workerLoop(std::size_t worker);
+    [[nodiscard]] bool findJob(std::size_t worker, Job& job);
+    static void execute(const Job& job, std::size_t worker);
+
+    std::vector<std::unique_ptr<Queue>> m_queues{};
+    std::vector<std::thread> m_threads{};
+
+    // jobs sitting in a queue, workers sleep while this is 0
+    std::atomic<std::size_t> m_queued{0};
+    std::atomic<bool> m_quit{false};
+    std::mutex m_wakeMutex{};
+    std::condition_variable m_wake{};
+};
+
+#endif
@@ -0,0 +1,315 @@
+#include "kernels.hpp"
+
+// sse2 is only part of the baseline on x86-64, 32 bit builds get the scalar kernels
+#if defined(__x86_64__)
+#include <immintrin.h>
+#define KERNELS_X86
+#endif
+
+namespace
+{
+    // ---- scalar, also finishes the tail the wide versions leave over ---- //
+
+    void integrateScalar(float* pos, const float* vel, const std::size_t begin, const std::size_t count, const float dt)
+    {
+        for (std::size_t i{begin}; i < count; ++i)
+        {
+            pos[i] += vel[i] * dt;
+        }
+    }
+
+    void advanceScalar(float* pos, const float* dir, const float* speed, const std::size_t begin, const std::size_t count, const float dt)
+    {
+        for (std::size_t i{begin}; i < count; ++i)
+        {
+            pos[i] += dir[i] * speed[i] * dt;
+        }
+    }
+
+    void addScalar(float* values, const std::size_t begin, const std::size_t count, const float amount)
+    {
+        for (std::size_t i{begin}; i < count; ++i)
+        {
+            values[i] += amount;
+        }
+    }
+
+    void scaleScalar(float* values, const std::size_t begin, const std::size_t count, const float factor)
+    {
+        for (std::size_t i{begin}; i < count; ++i)
+        {
+            values[i] *= factor;
+        }
+    }
+
+    std::size_t findDeadScalar(const float* life, const std::size_t begin, const std::size_t count)
+    {
+        for (std::size_t i{begin}; i < count; ++i)
+        {
+            if (life[i] <= 0.0f)
+            {
+                return i;
+            }
+        }
+        return count;
+    }
+
+#ifdef KERNELS_X86
+    // ---- sse ---- //
+
+    void integrateSse(float* pos, const float* vel, const std::size_t count, const float dt)
+    {
+        const __m128 step {_mm_set1_ps(dt)};
+        std::size_t i{0};
+        for (; i + 4 <= count; i += 4)
+        {
+            _mm_storeu_ps(pos + i, _mm_add_ps(_mm_loadu_ps(pos + i), _mm_mul_ps(_mm_loadu_ps(vel + i), step)));
+        }
+        integrateScalar(pos, vel, i, count, dt);
+    }
+
+    void advanceSse(float* pos, const float* dir, const float* speed, const std::size_t count, const float dt)
+    {
+        const __m128 step {_mm_set1_ps(dt)};
+        std::size_t i{0};
+        for (; i + 4 <= count; i += 4)
+        {
+            const __m128 vel {_mm_mul_ps(_mm_loadu_ps(dir + i), _mm_loadu_ps(speed + i))};
+            _mm_storeu_ps(pos + i, _mm_add_ps(_mm_loadu_ps(pos + i), _mm_mul_ps(vel, step)));
+        }
+        advanceScalar(pos, dir, speed, i, count, dt);
+    }
+
+    void addSse(float* values, const std::size_t count, const float amount)
+    {
+        const __m128 a {_mm_set1_ps(amount)};
+        std::size_t i{0};
+        for (; i + 4 <= count; i += 4)
+        {
+            _mm_storeu_ps(values + i, _mm_add_ps(_mm_loadu_ps(values + i), a));
+        }
+        addScalar(values, i, count, amount);
+    }
+
+    void scaleSse(float* values, const std::size_t count, const float factor)
+    {
+        const __m128 f {_mm_set1_ps(factor)};
+        std::size_t i{0};
+        for (; i + 4 <= count; i += 4)
+        {
+            _mm_storeu_ps(values + i, _mm_mul_ps(_mm_loadu_ps(values + i), f));
+        }
+        scaleScalar(values, i, count, factor);
+    }
+
+    std::size_t findDeadSse(const float* life, const std::size_t begin, const std::size_t count)
+    {
+        const __m128 zero {_mm_setzero_ps()};
+        std::size_t i{begin};
+        for (; i + 4 <= count; i += 4)
+        {
+            // skip four live ones at a time, the scalar loop finds which one it was
+            if (_mm_movemask_ps(_mm_cmple_ps(_mm_loadu_ps(life + i), zero)) != 0)
+            {
+                return findDeadScalar(life, i, i + 4);
+            }
+        }
+        return findDeadScalar(life, i, count);
+    }
+
+    // ---- avx2, compiled for it here only so the rest of the game runs on any x86-64 ---- //
+
+    __attribute__((target("avx2"))) void integrateAvx(float* pos, const float* vel, const std::size_t count, const float dt)
+    {
+        const __m256 step {_mm256_set1_ps(dt)};
+        std::size_t i{0};
+        for (; i + 8 <= count; i += 8)
+        {
+            _mm256_storeu_ps(pos + i, _mm256_add_ps(_mm256_loadu_ps(pos + i), _mm256_mul_ps(_mm256_loadu_ps(vel + i), step)));
+        }
+        integrateScalar(pos, vel, i, count, dt);
+    }
+
+    __attribute__((target("avx2"))) void advanceAvx(float* pos, const float* dir, const float* speed, const std::size_t count, const float dt)
+    {
+        const __m256 step {_mm256_set1_ps(dt)};
+        std::size_t i{0};
+        for (; i + 8 <= count; i += 8)
+        {
+            const __m256 vel {_mm256_mul_ps(_mm256_loadu_ps(dir + i), _mm256_loadu_ps(speed + i))};
+            _mm256_storeu_ps(pos + i, _mm256_add_ps(_mm256_loadu_ps(pos + i), _mm256_mul_ps(vel, step)));
+        }
+        advanceScalar(pos, dir, speed, i, count, dt);
+    }
+
+    __attribute__((target("avx2"))) void addAvx(float* values, const std::size_t count, const float amount)
+    {
+        const __m256 a {_mm256_set1_ps(amount)};
+        std::size_t i{0};
+        for (; i + 8 <= count; i += 8)
+        {
+            _mm256_storeu_ps(values + i, _mm256_add_ps(_mm256_loadu_ps(values + i), a));
+        }
+        addScalar(values, i, count, amount);
+    }
+
+    __attribute__((target("avx2"))) void scaleAvx(float* values, const std::size_t count, const float factor)
+    {
+        const __m256 f {_mm256_set1_ps(factor)};
+        std::size_t i{0};
+        for (; i + 8 <= count; i += 8)
+        {
+            _mm256_storeu_ps(values + i, _mm256_mul_ps(_mm256_loadu_ps(values + i), f));
+        }
+        scaleScalar(values, i, count, factor);
+    }
+
+    __attribute__((target("avx2"))) std::size_t findDeadAvx(const float* life, const std::size_t begin, const std::size_t count)
+    {
+        const __m256 zero {_mm256_setzero_ps()};
+        std::size_t i{begin};
+        for (; i + 8 <= count; i += 8)
+        {
+            if (_mm256_movemask_ps(_mm256_cmp_ps(_mm256_loadu_ps(life + i), zero, _CMP_LE_OQ)) != 0)
+            {
+                return findDeadScalar(life, i, i + 8);
+            }
+        }
+        return findDeadScalar(life, i, count);
+    }
+#endif
+
+    SimdLevel detectLevel()
+    {
+#ifdef KERNELS_X86
+        __builtin_cpu_init();
+        if (__builtin_cpu_supports("avx2"))
+        {
+            return SimdLevel::AVX2;
+        }
+        return SimdLevel::SSE;
+#else
+        return SimdLevel::SCALAR;
+#endif
+    }
+
+    const SimdLevel s_bestLevel {detectLevel()};
+    SimdLevel s_level {s_bestLevel};
+}
+
+SimdLevel Kernels::getLevel()
+{
+    return s_level;
+}
+
+SimdLevel Kernels::getBestLevel()
+{
+    return s_bestLevel;
+}
+
+void Kernels::setLevel(const SimdLevel level)
+{
+    s_level = static_cast<int>(level) > static_cast<int>(s_bestLevel) ? s_bestLevel : level;
+}
+
+const char* Kernels::getLevelName(const SimdLevel level)
+{
+    switch (level)
+    {
+        case SimdLevel::SCALAR:
+            return "scalar";
+        case SimdLevel::SSE:
+            return "sse";
+        case SimdLevel::AVX2:
+            return "avx2";
+        default:
+            return "unknown";
+    }
+}
+
+void Kernels::integrate(float* pos, const float* vel, const std::size_t count, const float dt)
+{
+    switch (s_level)
+    {
+#ifdef KERNELS_X86
+        case SimdLevel::AVX2:
+            integrateAvx(pos, vel, count, dt);
+            return;
+        case SimdLevel::SSE:
+            integrateSse(pos, vel, count, dt);
+            return;
+#endif
+        default:
+            integrateScalar(pos, vel, 0, count, dt);
+            return;
+    }
+}
+
+void Kernels::advance(float* pos, const float* dir, const float* speed, const std::size_t count, const float dt)
+{
+    switch (s_level)
+    {
+#ifdef KERNELS_X86
+        case SimdLevel::AVX2:
+            advanceAvx(pos, dir, speed, count, dt);
+            return;
+        case SimdLevel::SSE:
+            advanceSse(pos, dir, speed, count, dt);
+            return;
+#endif
+        default:
+            advanceScalar(pos, dir, speed, 0, count, dt);
+            return;
+    }
+}
+
+void Kernels::add(float* values, const std::size_t count, const float amount)
+{
+    switch (s_level)
+    {
+#ifdef KERNELS_X86
+        case SimdLevel::AVX2:
+            addAvx(values, count, amount);
+            return;
+        case SimdLevel::SSE:
+            addSse(values, count, amount);
+            return;
+#endif
+        default:
+            addScalar(values, 0, count, amount);
+            return;
+    }
+}
+
+void Kernels::scale(float* values, const std::size_t count, const float factor)
+{
+    switch (s_level)
+    {
+#ifdef KERNELS_X86
+        case SimdLevel::AVX2:
+            scaleAvx(values, count, factor);
+            return;
+        case SimdLevel::SSE:
+            scaleSse(values, count, factor);
+            return;
+#endif
+        default:
+            scaleScalar(values, 0, count, factor);
+            return;
+    }
+}
+
+std::size_t Kernels::findDead(const float* life, const std::size_t begin, const std::size_t count)
+{
+    switch (s_level)
+    {
+#ifdef KERNELS_X86
+        case SimdLevel::AVX2:
+            return findDeadAvx(life, begin, count);
+        case SimdLevel::SSE:
+            return findDeadSse(life, begin, count);
+#endif
+        default:
+            return findDeadScalar(life, begin, count);
+    }
+}
@@ -0,0 +1,37 @@
+#ifndef KERNELS_H
+#define KERNELS_H
+
+#include <cstddef>
+
+// which instruction set the kernels below run on
+enum class SimdLevel
+{
+    SCALAR,
+    SSE, // 4 floats at a time, always there on x86-64 (the only target the wide kernels are built for)
+    AVX2, // 8 floats at a time, used if the cpu has it
+};
+
+// float array loops for the particle pools, picked at startup for the best instruction set the cpu
+// supports. every level does the same math in the same order, so they all give the same result
+namespace Kernels
+{
+    [[nodiscard]] SimdLevel getLevel();
+    // the best level this cpu runs
+    [[nodiscard]] SimdLevel getBestLevel();
+    // force a level (benchmarks), anything above getBestLevel is clamped to it
+    void setLevel(SimdLevel level);
+    [[nodiscard]] const char* getLevelName(SimdLevel level);
+
+    // pos += vel * dt
+    void integrate(float* pos, const float* vel, std::size_t count, float dt);
+    // pos += dir * speed * dt
+    void advance(float* pos, const float* dir, const float* speed, std::size_t count, float dt);
+    // values += amount (gravity, decay)
+    void add(float* values, std::size_t count, float amount);
+    // values *= factor (friction)
+    void scale(float* values, std::size_t count, float factor);
+    // first index in [begin, count) with life <= 0, count if there's none
+    [[nodiscard]] std::size_t findDead(const float* life, std::size_t begin, std::size_t count);
+}
+
+#endif
@@ -0,0 +1,278 @@
+#include "levelfile.hpp"
+#include "constants.hpp"
+#include "util.hpp"
+
+#include <iostream>
+#include <map>
+#include <utility>
+#include <cstring>
+#include <cmath>
+#include <limits>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace
+{
+    struct ChunkBucket
+    {
+        std::vector<LevelFile::PackedTile> tiles{};
+        std::vector<LevelFile::PackedDecor> decor{};
+    };
+
+    // decor positions are whole pixels, chunks are this many of them across
+    constexpr int CHUNK_PIXELS {CST::TILE_SIZE * CST::CHUNK_SIZE};
+
+    template <typename T>
+    bool fits(const double value)
+    {
+        return static_cast<double>(std::numeric_limits<T>::min()) <= value && value <= static_cast<double>(std::numeric_limits<T>::max());
+    }
+
+    template <typename T>
+    void append(std::vector<char>& image, const T* data, const std::size_t count)
+    {
+        const std::size_t bytes {sizeof(T) * count};
+        const std::size_t offset {image.size()};
+        image.resize(offset + bytes);
+        if (bytes > 0)
+        {
+            std::memcpy(image.data() + offset, data, bytes);
+        }
+    }
+}
+
+std::vector<char> LevelFile::compile(const nlohmann::json& data)
+{
+    // bucket everything by chunk, std::map keeps the (y, x) order for the chunk table
+    std::map<std::pair<int, int>, ChunkBucket> buckets{};
+
+    // tiles on the grid (tile coords)
+    for (const auto& tile : data["level"]["tiles"])
+    {
+        const double x {tile["pos"][0]};
+        const double y {tile["pos"][1]};
+        const int type {tile["type"]};
+        const int variant {tile["variant"]};
+        // packed tiles store 16 bit coords, anything further out would end up in the wrong chunk
+        if (!fits<std::int16_t>(x) || !fits<std::int16_t>(y) || type < 0 || type >= NUM_TILE_TYPES || variant < 0 || variant >= TILE_VARIANTS)
+        {
+            std::cout << "ERROR: Tile at " << x << ", " << y << " (type " << type << ", variant " << variant << ") doesn't fit the level format!\n";
+            return {};
+        }
+        const int tileX {static_cast<int>(x)};
+        const int tileY {static_cast<int>(y)};
+        ChunkBucket& bucket {buckets[{Util::floorDiv(tileY, CST::CHUNK_SIZE), Util::floorDiv(tileX, CST::CHUNK_SIZE)}]};
+        bucket.tiles.push_back(PackedTile{static_cast<std::int16_t>(tileX), static_cast<std::int16_t>(tileY),
+            static_cast<std::uint8_t>(type), static_cast<std::uint8_t>(variant), 0});
+    }
+
+    // decor (off grid, pixel coords)
+    for (const auto& tile : data["level"]["off_grid"])
+    {
+        const double x {std::floor(tile["pos"][0].get<double>())};
+        const double y {std::floor(tile["pos"][1].get<double>())};
+        const int type {tile["type"]};
+        const int variant {tile["variant"]};
+        if (!fits<std::int32_t>(x) || !fits<std::int32_t>(y) || type != DECOR_TYPE || variant < 0 || variant >= DECOR_VARIANTS)
+        {
+            std::cout << "ERROR: Decor at " << x << ", " << y << " (type " << type << ", variant " << variant << ") doesn't fit the level format!\n";
+            return {};
+        }
+        const int pixelX {static_cast<int>(x)};
+        const int pixelY {static_cast<int>(y)};
+        ChunkBucket& bucket {buckets[{Util::floorDiv(pixelY, CHUNK_PIXELS), Util::floorDiv(pixelX, CHUNK_PIXELS)}]};
+        bucket.decor.push_back(PackedDecor{pixelX, pixelY, static_cast<std::uint8_t>(type), static_cast<std::uint8_t>(variant), 0});
+    }
+
+    std::vector<ChunkEntry> chunks{};
+    std::vector<PackedTile> tiles{};
+    std::vector<PackedDecor> decor{};
+    std::int32_t widthChunks {0};
+    std::int32_t heightChunks {0};
+    for (const auto& [loc, bucket] : buckets)
+    {
+        chunks.push_back(ChunkEntry{loc.second, loc.first,
+            static_cast<std::uint32_t>(tiles.size()), static_cast<std::uint32_t>(bucket.tiles.size()),
+            static_cast<std::uint32_t>(decor.size()), static_cast<std::uint32_t>(bucket.decor.size())});
+        tiles.insert(tiles.end(), bucket.tiles.begin(), bucket.tiles.end());
+        decor.insert(decor.end(), bucket.decor.begin(), bucket.decor.end());
+        widthChunks = std::max(widthChunks, loc.second + 1);
+        heightChunks = std::max(heightChunks, loc.first + 1);
+    }
+
+    Header header{};
+    std::memcpy(header.magic, MAGIC, sizeof(MAGIC));
+    header.version = VERSION;
+    header.tileSize = CST::TILE_SIZE;
+    header.chunkSize = CST::CHUNK_SIZE;
+    header.widthChunks = widthChunks;
+    header.heightChunks = heightChunks;
+    header.numChunks = static_cast<std::uint32_t>(chunks.size());
+    header.numTiles = static_cast<std::uint32_t>(tiles.size());
+    header.numDecor = static_cast<std::uint32_t>(decor.size());
+    header.chunksOffset = sizeof(Header);
+    header.tilesOffset = header.chunksOffset + sizeof(ChunkEntry) * header.numChunks;
+    header.decorOffset = header.tilesOffset + sizeof(PackedTile) * header.numTiles;
+
+    std::vector<char> image{};
+    image.reserve(header.decorOffset + sizeof(PackedDecor) * header.numDecor);
+    append(image, &header, 1);
+    append(image, chunks.data(), chunks.size());
+    append(image, tiles.data(), tiles.size());
+    append(image, decor.data(), decor.size());
+    return image;
+}
+
+std::string LevelFile::compiledPath(const std::string& jsonPath)
+{
+    const std::size_t dot {jsonPath.find_last_of('.')};
+    const std::size_t slash {jsonPath.find_last_of('/')};
+    if (dot == std::string::npos || (slash != std::string::npos && dot < slash))
+    {
+        return jsonPath + EXTENSION;
+    }
+    return jsonPath.substr(0, dot) + EXTENSION;
+}
+
+// --------- CompiledLevel --------- //
+
+CompiledLevel::~CompiledLevel()
+{
+    close();
+}
+
+bool CompiledLevel::open(const char* path)
+{
+    close();
+
+    const int fd {::open(path, O_RDONLY)};
+    if (fd < 0)
+    {
+        return false;
+    }
+
+    struct stat info{};
+    if (fstat(fd, &info) != 0 || info.st_size <= 0)
+    {
+        ::close(fd);
+        return false;
+    }
+
+    void* data {mmap(nullptr, static_cast<std::size_t>(info.st_size), PROT_READ, MAP_PRIVATE, fd, 0)};
+    // the mapping stays valid after closing the file
+    ::close(fd);
+    if (data == MAP_FAILED)
+    {
+        return false;
+    }
+
+    m_data = static_cast<const char*>(data);
+    m_size = static_cast<std::size_t>(info.st_size);
+    m_mapped = true;
+
+    if (!validate())
+    {
+        std::cout << "ERROR: Compiled level `" << path << "` is invalid or out of date!\n";
+        close();
+        return false;
+    }
+    return true;
+}
+
+bool CompiledLevel::open(std::vector<char>&& image)
+{
+    close();
+
+    m_image = std::move(image);
+    m_data = m_image.data();
+    m_size = m_image.size();
+
+    if (!validate())
+    {
+        close();
+        return false;
+    }
+    return true;
+}
+
+void CompiledLevel::close()
+{
+    if (m_mapped)
+    {
+        munmap(const_cast<char*>(m_data), m_size);
+    }
+    m_data = nullptr;
+    m_size = 0;
+    m_mapped = false;
+    m_image.clear();
+    m_image.shrink_to_fit();
+}
+
+void CompiledLevel::swap(CompiledLevel& other) noexcept
+{
+    // swapping the vectors keeps their buffers, so m_data stays valid for in memory images
+    std::swap(m_data, other.m_data);
+    std::swap(m_size, other.m_size);
+    std::swap(m_mapped, other.m_mapped);
+    m_image.swap(other.m_image);
+}
+
+bool CompiledLevel::validate() const
+{
+    if (m_data == nullptr || m_size < sizeof(LevelFile::Header))
+    {
+        return false;
+    }
+
+    const LevelFile::Header& header {getHeader()};
+    if (std::memcmp(header.magic, LevelFile::MAGIC, sizeof(LevelFile::MAGIC)) != 0 || header.version != LevelFile::VERSION
+        || header.tileSize != CST::TILE_SIZE || header.chunkSize != CST::CHUNK_SIZE)
+    {
+        return false;
+    }
+
+    // sections have to fit in the file
+    if (header.chunksOffset + static_cast<std::size_t>(header.numChunks) * sizeof(LevelFile::ChunkEntry) > m_size
+        || header.tilesOffset + static_cast<std::size_t>(header.numTiles) * sizeof(LevelFile::PackedTile) > m_size
+        || header.decorOffset + static_cast<std::size_t>(header.numDecor) * sizeof(LevelFile::PackedDecor) > m_size)
+    {
+        return false;
+    }
+
+    const LevelFile::ChunkEntry* chunks {getChunks()};
+    const LevelFile::PackedTile* tiles {getTiles()};
+    const LevelFile::PackedDecor* decor {getDecor()};
+    for (std::uint32_t i{0}; i < header.numChunks; ++i)
+    {
+        const LevelFile::ChunkEntry& chunk {chunks[i]};
+        if (static_cast<std::size_t>(chunk.firstTile) + chunk.numTiles > header.numTiles
+            || static_cast<std::size_t>(chunk.firstDecor) + chunk.numDecor > header.numDecor)
+        {
+            return false;
+        }
+
+        // the chunk builder indexes its grid with these, so a tile outside its chunk would write out of bounds
+        for (std::uint32_t t{chunk.firstTile}; t < chunk.firstTile + chunk.numTiles; ++t)
+        {
+            const LevelFile::PackedTile& tile {tiles[t]};
+            if (Util::floorDiv(tile.x, CST::CHUNK_SIZE) != chunk.x || Util::floorDiv(tile.y, CST::CHUNK_SIZE) != chunk.y
+                || tile.type >= LevelFile::NUM_TILE_TYPES || tile.variant >= LevelFile::TILE_VARIANTS)
+            {
+                return false;
+            }
+        }
+        for (std::uint32_t d{chunk.firstDecor}; d < chunk.firstDecor + chunk.numDecor; ++d)
+        {
+            const LevelFile::PackedDecor& piece {decor[d]};
+            if (Util::floorDiv(piece.x, CHUNK_PIXELS) != chunk.x || Util::floorDiv(piece.y, CHUNK_PIXELS) != chunk.y
+                || piece.type != LevelFile::DECOR_TYPE || piece.variant >= LevelFile::DECOR_VARIANTS)
+            {
+                return false;
+            }
+        }
+    }
+    return true;
+}
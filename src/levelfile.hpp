@@ -0,0 +1,116 @@
+#ifndef LEVELFILE_H
+#define LEVELFILE_H
+
+#include <JSON/json.hpp>
+
+#include <cstdint>
+#include <cstddef>
+#include <vector>
+#include <string>
+
+// compiled (binary) level format, built from the editor json by the level_compiler tool
+//
+// layout: Header | ChunkEntry[numChunks] | PackedTile[numTiles] | PackedDecor[numDecor]
+// chunk entries are sorted by (y, x) and only exist for chunks that have tiles or decor,
+// each entry points at a contiguous run of tiles and decor, so a chunk loads with one copy
+namespace LevelFile
+{
+    inline constexpr char MAGIC[4] {'S', 'M', 'L', 'V'};
+    inline constexpr std::uint32_t VERSION {1};
+    inline constexpr const char* EXTENSION {".lvl"};
+
+    // editor ids and sprite sheet sizes a level may use (see World::getTileType / getDecorType)
+    inline constexpr int NUM_TILE_TYPES {2}; // 0 grass, 1 sand
+    inline constexpr int DECOR_TYPE {2};
+    inline constexpr int TILE_VARIANTS {16}; // 4x4 autotile sheet
+    inline constexpr int DECOR_VARIANTS {9};
+
+    struct Header
+    {
+        char magic[4];
+        std::uint32_t version;
+        std::int32_t tileSize;
+        std::int32_t chunkSize;
+        std::int32_t widthChunks; // level bounds (in chunks) covered by the entries
+        std::int32_t heightChunks;
+        std::uint32_t numChunks;
+        std::uint32_t numTiles;
+        std::uint32_t numDecor;
+        std::uint32_t chunksOffset; // byte offsets from the start of the file
+        std::uint32_t tilesOffset;
+        std::uint32_t decorOffset;
+    };
+
+    struct ChunkEntry
+    {
+        std::int32_t x; // chunk coords
+        std::int32_t y;
+        std::uint32_t firstTile;
+        std::uint32_t numTiles;
+        std::uint32_t firstDecor;
+        std::uint32_t numDecor;
+    };
+
+    struct PackedTile
+    {
+        std::int16_t x; // tile coords
+        std::int16_t y;
+        std::uint8_t type; // editor type id
+        std::uint8_t variant;
+        std::uint16_t pad;
+    };
+
+    struct PackedDecor
+    {
+        std::int32_t x; // absolute pixel position
+        std::int32_t y;
+        std::uint8_t type; // editor type id
+        std::uint8_t variant;
+        std::uint16_t pad;
+    };
+
+    // build the binary level image from the editor json, empty if the map has tiles that don't fit the format
+    std::vector<char> compile(const nlohmann::json& data);
+
+    // get the compiled level path for a json map (data/maps/0.json -> data/maps/0.lvl)
+    std::string compiledPath(const std::string& jsonPath);
+}
+
+// read only view of a compiled level, either mmap'ed from disk or owning an in memory image
+class CompiledLevel
+{
+public:
+    CompiledLevel() = default;
+    ~CompiledLevel();
+
+    CompiledLevel(const CompiledLevel&) = delete;
+    CompiledLevel& operator=(const CompiledLevel&) = delete;
+
+    // map a compiled level file, returns false if it's missing or invalid
+    bool open(const char* path);
+    // take ownership of an image built with LevelFile::compile
+    bool open(std::vector<char>&& image);
+
+    void close();
+    // exchange the images, used to swap in a freshly opened level
+    void swap(CompiledLevel& other) noexcept;
+
+    [[nodiscard]] bool isOpen() const {return m_data != nullptr;}
+
+    [[nodiscard]] const LevelFile::Header& getHeader() const {return *reinterpret_cast<const LevelFile::Header*>(m_data);}
+    [[nodiscard]] const LevelFile::ChunkEntry* getChunks() const {return reinterpret_cast<const LevelFile::ChunkEntry*>(m_data + getHeader().chunksOffset);}
+    [[nodiscard]] const LevelFile::PackedTile* getTiles() const {return reinterpret_cast<const LevelFile::PackedTile*>(m_data + getHeader().tilesOffset);}
+    [[nodiscard]] const LevelFile::PackedDecor* getDecor() const {return reinterpret_cast<const LevelFile::PackedDecor*>(m_data + getHeader().decorOffset);}
+
+private:
+    // check the header, that every entry points inside the image and that everything in a chunk's
+    // range lies inside that chunk with a known type and variant
+    bool validate() const;
+
+    const char* m_data{nullptr};
+    std::size_t m_size{0};
+    bool m_mapped{false};
+    std::vector<char> m_image{};
+};
+
+#endif
@@ -0,0 +1,207 @@
+#include "navigation.hpp"
+#include "constants.hpp"
+
+#include <cmath>
+#include <algorithm>
+
+namespace
+{
+    constexpr int MAX_JUMP_ACROSS {2};
+}
+
+bool FlowField::isStandable(const int x, const int y) const
+{
+    return 0 <= x && x < m_width && 0 <= y && y < m_height && m_standable[static_cast<std::size_t>(y) * m_width + x];
+}
+
+void FlowField::update(const World* world, const Rectangle& target)
+{
+    const bool rebuild {!m_built || world->getRevision() != m_revision};
+    if (rebuild)
+    {
+        buildGraph(world);
+    }
+
+    // airborne targets count as the floor they'll land on
+    const int node {findNode(target, m_height)};
+    if (rebuild || node != m_target)
+    {
+        search(node);
+    }
+}
+
+FlowStep FlowField::sample(const Rectangle& body) const
+{
+    // a jump apex is about a tile up, so look a little below for the floor
+    const int node {findNode(body, 2)};
+    if (node < 0)
+    {
+        return FlowStep{};
+    }
+    return m_steps[node];
+}
+
+int FlowField::findNode(const Rectangle& body, const int maxDrop) const
+{
+    if (m_width == 0)
+    {
+        return -1;
+    }
+    const int x {static_cast<int>(std::floor((body.x + body.width * 0.5f) / (float)CST::TILE_SIZE))};
+    // cell the feet are in, a body resting on the floor sits exactly on the tile edge
+    const int y {std::max(0, static_cast<int>(std::floor((body.y + body.height - 0.01f) / (float)CST::TILE_SIZE)))};
+    for (int drop{0}; drop <= maxDrop && y + drop < m_height; ++drop)
+    {
+        if (isStandable(x, y + drop))
+        {
+            return (y + drop) * m_width + x;
+        }
+    }
+    return -1;
+}
+
+void FlowField::buildGraph(const World* world)
+{
+    m_width = world->getWidthChunks() * CST::CHUNK_SIZE;
+    m_height = world->getHeightChunks() * CST::CHUNK_SIZE;
+    m_revision = world->getRevision();
+    m_built = true;
+    ++m_builds;
+
+    const std::size_t numNodes {static_cast<std::size_t>(m_width) * m_height};
+    m_standable.assign(numNodes, 0);
+    for (int y{0}; y < m_height; ++y)
+    {
+        for (int x{0}; x < m_width; ++x)
+        {
+            // the bottom of the level is a floor too (see Physics::move)
+            m_standable[static_cast<std::size_t>(y) * m_width + x] = !world->isSolid(x, y) && (world->isSolid(x, y + 1) || y + 1 == m_height);
+        }
+    }
+
+    m_edgeStart.assign(numNodes + 1, 0);
+    m_edges.clear();
+    for (int y{0}; y < m_height; ++y)
+    {
+        for (int x{0}; x < m_width; ++x)
+        {
+            const int node {y * m_width + x};
+            m_edgeStart[node] = static_cast<int>(m_edges.size());
+            if (!m_standable[node])
+            {
+                continue;
+            }
+
+            for (const int side : {-1, 1})
+            {
+                const int nx {x + side};
+                if (nx < 0 || nx >= m_width || world->isSolid(nx, y))
+                {
+                    continue;
+                }
+                // walk, or walk off the ledge and fall to the first floor
+                for (int ny{y}; ny < m_height && !world->isSolid(nx, ny); ++ny)
+                {
+                    if (isStandable(nx, ny))
+                    {
+                        m_edges.push_back(Edge{ny * m_width + nx, false});
+                        break;
+                    }
+                }
+            }
+
+            // jump up a tile, needs headroom above us and along the way
+            if (y > 0 && !world->isSolid(x, y - 1))
+            {
+                for (const int side : {-1, 1})
+                {
+                    for (int across{1}; across <= MAX_JUMP_ACROSS; ++across)
+                    {
+                        const int nx {x + side * across};
+                        if (world->isSolid(nx, y - 1))
+                        {
+                            break;
+                        }
+                        if (isStandable(nx, y - 1))
+                        {
+                            m_edges.push_back(Edge{(y - 1) * m_width + nx, true});
+                            break;
+                        }
+                    }
+                }
+            }
+        }
+    }
+    m_edgeStart[numNodes] = static_cast<int>(m_edges.size());
+
+    // flip the edges for the search
+    m_reverseStart.assign(numNodes + 1, 0);
+    for (const Edge& edge : m_edges)
+    {
+        ++m_reverseStart[edge.to + 1];
+    }
+    for (std::size_t i{0}; i < numNodes; ++i)
+    {
+        m_reverseStart[i + 1] += m_reverseStart[i];
+    }
+    m_reverse.resize(m_edges.size());
+    std::vector<int> fill(m_reverseStart.begin(), m_reverseStart.end() - 1);
+    for (std::size_t node{0}; node < numNodes; ++node)
+    {
+        for (int e{m_edgeStart[node]}; e < m_edgeStart[node + 1]; ++e)
+        {
+            m_reverse[fill[m_edges[e].to]++] = static_cast<int>(node);
+        }
+    }
+}
+
+void FlowField::search(const int target)
+{
+    m_target = target;
+    ++m_searches;
+
+    const std::size_t numNodes {m_standable.size()};
+    m_distance.assign(numNodes, -1);
+    m_steps.assign(numNodes, FlowStep{});
+    if (target < 0)
+    {
+        return;
+    }
+
+    // reverse BFS, every move costs the same
+    m_queue.clear();
+    m_queue.push_back(target);
+    m_distance[target] = 0;
+    for (std::size_t head{0}; head < m_queue.size(); ++head)
+    {
+        const int node {m_queue[head]};
+        for (int r{m_reverseStart[node]}; r < m_reverseStart[node + 1]; ++r)
+        {
+            const int from {m_reverse[r]};
+            if (m_distance[from] < 0)
+            {
+                m_distance[from] = m_distance[node] + 1;
+                m_queue.push_back(from);
+            }
+        }
+    }
+
+    // bake the best move into every reachable node
+    for (const int node : m_queue)
+    {
+        FlowStep& step {m_steps[node]};
+        step.valid = true;
+        step.distance = m_distance[node];
+        int best {m_distance[node]};
+        for (int e{m_edgeStart[node]}; e < m_edgeStart[node + 1]; ++e)
+        {
+            const Edge& edge {m_edges[e]};
+            if (m_distance[edge.to] >= 0 && m_distance[edge.to] < best)
+            {
+                best = m_distance[edge.to];
+                step.dir = (edge.to % m_width) < (node % m_width) ? -1 : 1;
+                step.jump = edge.jump;
+            }
+        }
+    }
+}
@@ -0,0 +1,75 @@
+#ifndef NAVIGATION_H
+#define NAVIGATION_H
+
+#include "raylib.h"
+
+#include "tiles.hpp"
+
+#include <vector>
+#include <cstdint>
+
+// what an enemy standing in a cell should do to get closer to the target
+struct FlowStep
+{
+    bool valid{false}; // false if the body isn't near the ground or can't reach the target
+    int dir{0}; // -1 left, 1 right, 0 = already there
+    bool jump{false};
+    int distance{-1}; // moves left to the target
+};
+
+// distance to the player over the cells enemies can stand in, shared by every enemy
+//
+// nodes are empty tiles with a solid tile (or the bottom of the level) below, edges walk one tile sideways, walk off a ledge and fall
+// to the first floor below, or jump up one tile (1-2 across). a reverse BFS from the player's cell
+// gives every node its distance, and each node stores the edge that gets closer, so sampling is O(1)
+class FlowField
+{
+public:
+    FlowField() = default;
+
+    // rebuild the graph if the terrain changed, search again if the target moved to another cell
+    void update(const World* world, const Rectangle& target);
+
+    [[nodiscard]] FlowStep sample(const Rectangle& body) const;
+
+    // how many times the graph / search has been redone (for the benchmarks)
+    [[nodiscard]] int getBuilds() const {return m_builds;}
+    [[nodiscard]] int getSearches() const {return m_searches;}
+
+private:
+    struct Edge
+    {
+        int to;
+        bool jump;
+    };
+
+    void buildGraph(const World* world);
+    void search(int target);
+
+    // node the body is standing in (or just above), -1 if none
+    [[nodiscard]] int findNode(const Rectangle& body, int maxDrop) const;
+    [[nodiscard]] bool isStandable(int x, int y) const;
+
+    int m_width{0};
+    int m_height{0};
+    std::uint32_t m_revision{0};
+    bool m_built{false};
+    int m_target{-1};
+
+    std::vector<std::uint8_t> m_standable{};
+    // forward edges in CSR form, m_edgeStart[node] .. m_edgeStart[node + 1]
+    std::vector<int> m_edgeStart{};
+    std::vector<Edge> m_edges{};
+    // reverse edges (sources) for the search
+    std::vector<int> m_reverseStart{};
+    std::vector<int> m_reverse{};
+
+    std::vector<int> m_distance{};
+    std::vector<FlowStep> m_steps{};
+    std::vector<int> m_queue{};
+
+    int m_builds{0};
+    int m_searches{0};
+};
+
+#endif
@@ -1,353 +1,487 @@
 #include "particles.hpp"
 #include "util.hpp"
+#include "debug.hpp"
+#include "kernels.hpp"
 
 #include <rlgl.h>
 
-KnockbackManager::~KnockbackManager()
+// --------- BouncePool --------- //
+
+BouncePool::BouncePool(const std::size_t capacity, const BounceParams& params)
+ : m_capacity{capacity}, m_params{params}
 {
-    free();
+    Util::reserveAll(capacity, x, y, velX, velY, life, color);
+    m_hits.resize(capacity);
 }
 
-void KnockbackManager::free()
+void BouncePool::clear()
 {
-    for (std::size_t i{0}; i < std::size(m_particles); ++i)
-    {
-        delete m_particles[i];
-    }
-    m_particles.clear();
+    Util::clearAll(x, y, velX, velY, life, color);
 }
 
-void KnockbackManager::update(const float dt, const vec2<int>& scroll, World* world)
+void BouncePool::update(const float dt, const World* world)
 {
-    for (std::size_t i{0}; i < m_particles.size(); ++i)
+    const BounceParams p {m_params};
+    const std::size_t count {size()};
+
+    // the wide kernels do the plain math, the terrain check runs over the whole batch against the
+    // solid bitmap and only the particles that hit something get bounced
+    Kernels::integrate(x.data(), velX.data(), count, dt);
+    const std::size_t hitsX {world->findSolid(x.data(), y.data(), count, m_hits.data())};
+    for (std::size_t h{0}; h < hitsX; ++h)
     {
-        Knockback* p {m_particles[i]};
+        const std::size_t i {m_hits[h]};
+        x[i] -= velX[i] * dt;
+        velX[i] *= -p.bounce;
+        velY[i] *= p.friction;
+    }
 
-        constexpr float bounce{0.6f};
-        constexpr float friction{0.99f};
-        constexpr float decay{0.02f};
-        constexpr float gravity{0.16f};
+    Kernels::integrate(y.data(), velY.data(), count, dt);
+    Kernels::add(velY.data(), count, p.gravity * dt);
+    const std::size_t hitsY {world->findSolid(x.data(), y.data(), count, m_hits.data())};
+    for (std::size_t h{0}; h < hitsY; ++h)
+    {
+        const std::size_t i {m_hits[h]};
+        y[i] -= velY[i] * dt;
+        velY[i] *= -p.bounce;
+        velX[i] *= p.friction;
+    }
 
-        p->pos.x += p->vel.x * dt;
-        Tile* tile {world->getTileAt(p->pos.x, p->pos.y)};
-        if (tile != nullptr)
-        {
-            if (Util::elementIn<TileType, std::size(SOLID_TILES)>(tile->type, SOLID_TILES.data()))
-            {
-                p->pos.x -= p->vel.x * dt;
-                p->vel.x *= -bounce;
-                p->vel.y *= friction;
-            }
-        }
+    Kernels::add(life.data(), count, -p.decay);
 
-        p->pos.y += p->vel.y * dt;
-        p->vel.y += gravity * dt;
-        tile = world->getTileAt(p->pos.x, p->pos.y);
-        if (tile != nullptr)
-        {
-            if (Util::elementIn<TileType, std::size(SOLID_TILES)>(tile->type, SOLID_TILES.data()))
-            {
-                p->pos.y -= p->vel.y * dt;
-                p->vel.y *= -bounce;
-                p->vel.x *= friction;
-            }
-        }
+    for (std::size_t i {Kernels::findDead(life.data(), 0, size())}; i < size(); i = Kernels::findDead(life.data(), i, size()))
+    {
+        Util::swapRemove(i, x, y, velX, velY, life, color);
+    }
+}
 
-        p->size -= decay;
-        if (p->size <= 0.0f)
-        {
-            delete p;
-            m_particles[i] = nullptr;
-        } else {
-            DrawPixel(static_cast<int>(p->pos.x) - scroll.x, static_cast<int>(p->pos.y) - scroll.y, {p->color.r, p->color.g, p->color.b, static_cast<unsigned char>(static_cast<int>(p->size / m_startSize * 255.f))});
-        }
+bool BouncePool::add(const vec2<float> pos, const vec2<float> vel, const float startLife, const Color tint)
+{
+    if (size() >= m_capacity)
+    {
+        return false;
     }
+    x.push_back(pos.x);
+    y.push_back(pos.y);
+    velX.push_back(vel.x);
+    velY.push_back(vel.y);
+    life.push_back(startLife);
+    color.push_back(tint);
+    return true;
+}
 
-    m_particles.erase(std::remove_if(m_particles.begin(), m_particles.end(), [](Knockback* p){return p == nullptr;}), m_particles.end());
+// --------- SmokePool --------- //
+
+SmokePool::SmokePool(const std::size_t capacity)
+ : m_capacity{capacity}
+{
+    Util::reserveAll(capacity, x, y, velX, velY, targetAngle, angle, life);
 }
 
-void KnockbackManager::addParticle(vec2<float> pos, vec2<float> vel, Color color)
+void SmokePool::clear()
 {
-    m_particles.emplace_back(new Knockback{
-        pos,
-        vel,
-        m_startSize,
-        color
-    });
+    Util::clearAll(x, y, velX, velY, targetAngle, angle, life);
 }
 
-SmokeManager::~SmokeManager()
+void SmokePool::update(const float dt)
 {
-    free();
+    constexpr float decay{0.12f};
+    constexpr float friction{0.9f};
+
+    const std::size_t count {size()};
+    Kernels::integrate(x.data(), velX.data(), count, dt);
+    Kernels::integrate(y.data(), velY.data(), count, dt);
+
+    // v += (v * friction - v) * dt, folded into one factor
+    const float damping {1.f + (friction - 1.f) * dt};
+    Kernels::scale(velX.data(), count, damping);
+    Kernels::scale(velY.data(), count, damping);
+
+    for (std::size_t i{0}; i < count; ++i)
+    {
+        angle[i] += std::min((targetAngle[i] - angle[i]) * 0.5f, static_cast<float>(M_PI) * 0.05f) * dt;
+    }
+
+    Kernels::add(life.data(), count, -decay * dt);
+
+    for (std::size_t i {Kernels::findDead(life.data(), 0, size())}; i < size(); i = Kernels::findDead(life.data(), i, size()))
+    {
+        Util::swapRemove(i, x, y, velX, velY, targetAngle, angle, life);
+    }
 }
 
-void SmokeManager::free()
+void SmokePool::render(const Rectangle& view) const
 {
-    for (std::size_t i{0}; i < std::size(m_smoke); ++i)
+    const vec2<int> scroll {static_cast<int>(view.x), static_cast<int>(view.y)};
+    for (std::size_t i{0}; i < size(); ++i)
     {
-        delete m_smoke[i];
+        const float puff {START_SIZE - life[i]};
+        // puff is the side length, a rotated square never reaches further than that from its center
+        if (Util::inView(view, {x[i] - puff, y[i] - puff, puff * 2.f, puff * 2.f}))
+        {
+            DrawRectanglePro({x[i] - (float)scroll.x, y[i] - (float)scroll.y, puff, puff}, {puff * 0.5f, puff * 0.5f}, angle[i] * 180.f / static_cast<float>(M_PI),
+                {86, 105, 129, static_cast<unsigned char>(static_cast<int>(life[i] / START_SIZE * 250.f))});
+        }
     }
-    m_smoke.clear();
 }
 
-void SmokeManager::update(const float dt, const vec2<int> scroll)
+bool SmokePool::add(const vec2<float> pos, const vec2<float> vel)
 {
-    for (std::size_t i{0}; i < std::size(m_smoke); ++i)
+    if (size() >= m_capacity)
     {
-        constexpr float decay{0.12f};
-        constexpr float friction{0.9f};
-        Smoke* smoke {m_smoke[i]};
+        return false;
+    }
+    const float start{Util::random() * static_cast<float>(M_PI) * 2.f};
+    x.push_back(pos.x);
+    y.push_back(pos.y);
+    velX.push_back(vel.x);
+    velY.push_back(vel.y);
+    targetAngle.push_back(start + static_cast<float>(M_PI) * 6.f);
+    angle.push_back(start);
+    life.push_back(START_SIZE - Util::random());
+    return true;
+}
+
+// --------- ShockwavePool --------- //
 
-        smoke->pos.x += smoke->vel.x * dt;
-        smoke->pos.y += smoke->vel.y * dt;
+ShockwavePool::ShockwavePool(const std::size_t capacity)
+ : m_capacity{capacity}
+{
+    Util::reserveAll(capacity, x, y, targetRadius, innerRadius, outerRadius);
+}
+
+void ShockwavePool::clear()
+{
+    Util::clearAll(x, y, targetRadius, innerRadius, outerRadius);
+}
 
-        smoke->vel.x += (smoke->vel.x * friction - smoke->vel.x) * dt;
-        smoke->vel.y += (smoke->vel.y * friction - smoke->vel.y) * dt;
+void ShockwavePool::update(const float dt)
+{
+    constexpr float outerSpeed{2.f};
+    constexpr float innerSpeed{1.5f};
 
-        smoke->angle += std::min((smoke->targetAngle - smoke->angle) * 0.5f, static_cast<float>(M_PI) * 0.05f) * dt;
+    const std::size_t count {size()};
+    for (std::size_t i{0}; i < count; ++i)
+    {
+        outerRadius[i] = std::min(targetRadius[i], outerRadius[i] + outerSpeed * dt);
+    }
+    Kernels::add(innerRadius.data(), count, innerSpeed * dt);
 
-        smoke->size -= decay * dt;
-        if (smoke->size <= 0.0f)
+    for (std::size_t i{0}; i < size();)
+    {
+        if (innerRadius[i] >= targetRadius[i])
         {
-            delete m_smoke[i];
-            m_smoke[i] = nullptr;
-        } else {
-            // render smoke
-            const float size{m_startSize - smoke->size};
-            DrawRectanglePro({smoke->pos.x - (float)scroll.x, smoke->pos.y - (float)scroll.y, size, size}, {size * 0.5f, size * 0.5f}, smoke->angle * 180.f / static_cast<float>(M_PI), {86, 105, 129, static_cast<unsigned char>(static_cast<int>(smoke->size / m_startSize * 250.f))});
+            Util::swapRemove(i, x, y, targetRadius, innerRadius, outerRadius);
+            continue;
         }
+        ++i;
     }
+}
 
-    m_smoke.erase(std::remove_if(m_smoke.begin(), m_smoke.end(), [](Smoke* s){return s == nullptr;}), m_smoke.end());
+void ShockwavePool::render(const Rectangle& view) const
+{
+    const vec2<int> scroll {static_cast<int>(view.x), static_cast<int>(view.y)};
+    for (std::size_t i{0}; i < size(); ++i)
+    {
+        const float outer {outerRadius[i]};
+        if (Util::inView(view, {x[i] - outer, y[i] - outer, outer * 2.f, outer * 2.f}))
+        {
+            DrawRing({x[i] - (float)scroll.x, y[i] - (float)scroll.y}, innerRadius[i], outer, 0.0f, 360.f, 60, {255, 253, 240, 255});
+        }
+    }
 }
 
-void SmokeManager::addSmoke(const vec2<float> pos, const vec2<float> vel)
+bool ShockwavePool::add(const vec2<float> center, const float target)
 {
-    const float angle{Util::random() * static_cast<float>(M_PI) * 2.f};
-    m_smoke.emplace_back(new Smoke
+    if (size() >= m_capacity)
     {
-        pos,
-        vel,
-        angle + static_cast<float>(M_PI) * 6.f,
-        angle,
-        m_startSize - Util::random()
-    });
+        return false;
+    }
+    x.push_back(center.x);
+    y.push_back(center.y);
+    targetRadius.push_back(target);
+    innerRadius.push_back(0.0f);
+    outerRadius.push_back(0.0f);
+    return true;
+}
+
+// --------- FlamePool --------- //
+
+FlamePool::FlamePool(const std::size_t capacity)
+ : m_capacity{capacity}
+{
+    Util::reserveAll(capacity, x, y, velX, velY, anim);
 }
 
-ShockwaveManager::~ShockwaveManager()
+void FlamePool::clear()
 {
-    free();
+    Util::clearAll(x, y, velX, velY, anim);
 }
 
-void ShockwaveManager::free()
+void FlamePool::update(const float dt, const AnimSet* anims)
 {
-    for (std::size_t i{0}; i < std::size(m_shockwaves); ++i)
+    const std::size_t count {size()};
+    Kernels::integrate(x.data(), velX.data(), count, dt);
+    Kernels::integrate(y.data(), velY.data(), count, dt);
+    anims->tick(anim.data(), count, dt);
+
+    for (std::size_t i{0}; i < size();)
     {
-        delete m_shockwaves[i];
+        if (anims->getFinished(anim[i]))
+        {
+            Util::swapRemove(i, x, y, velX, velY, anim);
+            continue;
+        }
+        ++i;
     }
-    m_shockwaves.clear();
 }
 
-void ShockwaveManager::update(const float dt, const vec2<int> scroll)
+void FlamePool::render(const Rectangle& view, const AnimSet* anims) const
 {
-    for (std::size_t i{0}; i < std::size(m_shockwaves); ++i)
+    const vec2<int> scroll {static_cast<int>(view.x), static_cast<int>(view.y)};
+    for (std::size_t i{0}; i < size(); ++i)
     {
-        Shockwave* s{m_shockwaves[i]};
-
-        constexpr float outerSpeed{2.f};
-        constexpr float innerSpeed{1.5f};
-
-        s->outerRadius += outerSpeed * dt;
-        s->innerRadius += innerSpeed * dt;
-
-        if (s->innerRadius >= s->targetRadius)
+        const AnimClip& clip {anims->get(anim[i].clip)};
+        if (Util::inView(view, {x[i], y[i], static_cast<float>(clip.width), static_cast<float>(clip.height)}))
         {
-            delete s;
-            m_shockwaves[i] = nullptr;
-        } else {
-            s->outerRadius = std::min(s->targetRadius, s->outerRadius);
-            s->innerRadius = std::min(s->innerRadius, s->targetRadius);
-    
-            DrawRing({s->center.x - (float)scroll.x, s->center.y - (float)scroll.y}, s->innerRadius, s->outerRadius, 0.0f, 360.f, 60, {255, 253, 240, 255});
+            anims->render(anim[i], {x[i], y[i]}, scroll);
         }
     }
+}
 
-    m_shockwaves.erase(std::remove_if(m_shockwaves.begin(), m_shockwaves.end(), [](Shockwave* s){return s == nullptr;}), m_shockwaves.end());
+bool FlamePool::add(const vec2<float> pos, const vec2<float> vel, const AnimState& state)
+{
+    if (size() >= m_capacity)
+    {
+        return false;
+    }
+    x.push_back(pos.x);
+    y.push_back(pos.y);
+    velX.push_back(vel.x);
+    velY.push_back(vel.y);
+    anim.push_back(state);
+    return true;
 }
 
-void ShockwaveManager::addShockwave(const vec2<float> center, const float targetRadius)
+// --------- ParticleEngine --------- //
+
+void ParticleEngine::init(const AnimSet* anims, const Texture2D* blank)
 {
-    m_shockwaves.emplace_back(new Shockwave{
-        center,
-        targetRadius
-    });
+    m_anims = anims;
+    m_blank = blank;
 }
 
-FlameManager::FlameManager(AssetManager* assets)
- : m_flameTex{assets->getTexture("flame")}
+void ParticleEngine::clear()
 {
+    m_sparks.clear();
+    m_knockback.clear();
+    m_smoke.clear();
+    m_shockwaves.clear();
+    m_flames.clear();
+    m_cinders.clear();
+    m_dropped = 0;
+    m_scale = 1.f;
+    m_frameMs = 0.0f;
+    m_culled = 0;
 }
 
-FlameManager::~FlameManager()
+void ParticleEngine::update(const float dt, const World* world)
 {
-    free();
+    m_smoke.update(dt);
+    m_sparks.update(dt);
+    m_knockback.update(dt, world);
+    m_cinders.update(dt, world);
+    m_flames.update(dt, m_anims);
+    m_shockwaves.update(dt);
 }
 
-void FlameManager::free()
+void ParticleEngine::render(const Rectangle& view) const
 {
-    for (std::size_t i{0}; i < std::size(m_flames); ++i)
-    {
-        delete m_flames[i]->anim;
-        delete m_flames[i];
-    }
+    m_smoke.render(view);
+    m_sparks.render(view, m_blank, DBG::sparkDrawCalls);
+    renderKnockback(view);
+    renderCinders(view);
+    m_flames.render(view, m_anims);
+    m_shockwaves.render(view);
+}
 
-    m_flames.clear();
+void ParticleEngine::addSpark(const vec2<float> pos, const float angle, const float speed)
+{
+    m_dropped += !m_sparks.add(pos, angle, speed);
 }
 
-void FlameManager::update(const float dt, const vec2<int> scroll)
+void ParticleEngine::addKnockback(const vec2<float> pos, const vec2<float> vel, const Color color)
 {
-    for (std::size_t i{0}; i < std::size(m_flames); ++i)
-    {
-        Flame* f{m_flames[i]};
-        f->pos.x += f->vel.x * dt;
-        f->pos.y += f->vel.y * dt;
+    m_dropped += !m_knockback.add(pos, vel, KNOCKBACK_SIZE, color);
+}
 
-        f->anim->tick(dt);
+void ParticleEngine::addSmoke(const vec2<float> pos, const vec2<float> vel)
+{
+    m_dropped += !m_smoke.add(pos, vel);
+}
 
-        if (f->anim->getFinished())
-        {
-            delete m_flames[i]->anim;
-            m_flames[i]->anim = nullptr;
-            delete m_flames[i];
-            m_flames[i] = nullptr;
-        } else {
-            f->anim->render(f->pos, scroll);
-        }
-    }
+void ParticleEngine::addShockwave(const vec2<float> center, const float targetRadius)
+{
+    m_dropped += !m_shockwaves.add(center, targetRadius);
+}
 
-    m_flames.erase(std::remove_if(m_flames.begin(), m_flames.end(), [](Flame* f){return f == nullptr;}), m_flames.end());
+void ParticleEngine::addCinder(const vec2<float> pos, const vec2<float> vel, const Color color)
+{
+    m_dropped += !m_cinders.add(pos, vel, CINDER_SIZE - Util::random(), color);
 }
 
-void FlameManager::explode(vec2<float> pos, float intensity)
+void ParticleEngine::explode(const vec2<float> pos, const float intensity)
 {
-    for (std::size_t i{0}; i < static_cast<int>(Util::random() * 10.f * intensity + 10.f * intensity); ++i)
+    for (int i{0}; i < emitCount(PARTICLE_FLAME, Util::random() * 10.f * intensity + 10.f * intensity); ++i)
     {
         const float angle{Util::random() * static_cast<float>(M_PI) * 2.f};
         const float dist{Util::random() * 12.f * intensity};
-        Anim* anim {new Anim{5, 5, 9, 0.4f, false, m_flameTex}};
-        anim->setFrame(Util::random() < 0.5f ? 0.f : 1.f); // randomize it a bit
-        m_flames.emplace_back(new Flame{{pos.x + std::cos(angle) * dist, pos.y + std::sin(angle) * dist}, {0.0f, -0.9f}, anim});
+        const AnimState anim {Util::random() < 0.5f ? 0.f : 1.f, CLIP_FLAME}; // randomize it a bit
+        m_dropped += !m_flames.add({pos.x + std::cos(angle) * dist, pos.y + std::sin(angle) * dist}, {0.0f, -0.9f}, anim);
     }
 
-    for (std::size_t i{0}; i < static_cast<int>(Util::random() * 5.f * intensity + 5.f * intensity); ++i)
+    for (int i{0}; i < emitCount(PARTICLE_FLAME, Util::random() * 5.f * intensity + 5.f * intensity); ++i)
     {
         const float angle{Util::random() * static_cast<float>(M_PI) * 2.f};
-        Anim* anim {new Anim{5, 5, 9, 1.f, false, m_flameTex}};
-        anim->setFrame(Util::random() < 0.5f ? 0.f : 1.f); // randomize it a bit
-        m_flames.emplace_back(new Flame{pos, {std::cos(angle) * 5.f, std::sin(angle) * 5.f}, anim});
+        const AnimState anim {Util::random() < 0.5f ? 0.f : 1.f, CLIP_FLAME_FAST}; // randomize it a bit
+        m_dropped += !m_flames.add(pos, {std::cos(angle) * 5.f, std::sin(angle) * 5.f}, anim);
     }
 }
 
-CinderManager::CinderManager(AssetManager* assets)
- : m_blank{assets->getTexture("blank")}
+void ParticleEngine::govern(const float dt, const float frameMs)
 {
+    m_frameMs += (frameMs - m_frameMs) * std::min(1.f, 0.1f * dt);
+
+    // back off fast and recover slowly, same as the wave director
+    if (m_frameMs > FRAME_BUDGET)
+    {
+        m_scale = std::max(MIN_SCALE, m_scale - 0.05f * dt);
+    } else if (m_frameMs < FRAME_BUDGET * 0.8f)
+    {
+        m_scale = std::min(1.f, m_scale + 0.005f * dt);
+    }
 }
 
-CinderManager::~CinderManager()
+bool ParticleEngine::shouldEmit(const vec2<float> pos)
 {
-    free();
+    const Rectangle area {m_view.x - EMITTER_MARGIN, m_view.y - EMITTER_MARGIN, m_view.width + EMITTER_MARGIN * 2.f, m_view.height + EMITTER_MARGIN * 2.f};
+    if (CheckCollisionPointRec({pos.x, pos.y}, area))
+    {
+        return true;
+    }
+    ++m_culled;
+    return false;
 }
 
-void CinderManager::free()
+int ParticleEngine::emitCount(const ParticleType type, const float count) const
 {
-    for (std::size_t i{0}; i < std::size(m_particles); ++i)
+    const float priority {PRIORITY[type]};
+    if (priority < 1.f && getCount() >= m_liveCap)
     {
-        delete m_particles[i];
+        return 0;
     }
-    m_particles.clear();
+    return static_cast<int>(count * (m_scale + (1.f - m_scale) * priority));
 }
 
-void CinderManager::update(const float dt, const vec2<int> scroll, World* world)
+std::size_t ParticleEngine::getCount(const ParticleType type) const
 {
-    for (std::size_t i{0}; i < m_particles.size(); ++i)
+    switch (type)
     {
-        Cinder* p {m_particles[i]};
-
-        constexpr float bounce{0.7f};
-        constexpr float friction{0.99f};
-        constexpr float decay{0.1f};
-        constexpr float gravity{0.1f};
-
-        p->pos.x += p->vel.x * dt;
-        Tile* tile {world->getTileAt(p->pos.x, p->pos.y)};
-        if (tile != nullptr)
-        {
-            if (Util::elementIn<TileType, std::size(SOLID_TILES)>(tile->type, SOLID_TILES.data()))
-            {
-                p->pos.x -= p->vel.x * dt;
-                p->vel.x *= -bounce;
-                p->vel.y *= friction;
-            }
-        }
+        case PARTICLE_SPARK:
+            return m_sparks.size();
+        case PARTICLE_KNOCKBACK:
+            return m_knockback.size();
+        case PARTICLE_SMOKE:
+            return m_smoke.size();
+        case PARTICLE_SHOCKWAVE:
+            return m_shockwaves.size();
+        case PARTICLE_FLAME:
+            return m_flames.size();
+        case PARTICLE_CINDER:
+            return m_cinders.size();
+        default:
+            return 0;
+    }
+}
 
-        p->pos.y += p->vel.y * dt;
-        p->vel.y += gravity * dt;
-        tile = world->getTileAt(p->pos.x, p->pos.y);
-        if (tile != nullptr)
-        {
-            if (Util::elementIn<TileType, std::size(SOLID_TILES)>(tile->type, SOLID_TILES.data()))
-            {
-                p->pos.y -= p->vel.y * dt;
-                p->vel.y *= -bounce;
-                p->vel.x *= friction;
-            }
-        }
+std::size_t ParticleEngine::getCount() const
+{
+    std::size_t total {0};
+    for (std::size_t type{0}; type < NUM_PARTICLE_TYPES; ++type)
+    {
+        total += getCount(static_cast<ParticleType>(type));
+    }
+    return total;
+}
 
-        p->size -= decay;
-        if (p->size <= 0.0f)
+void ParticleEngine::renderKnockback(const Rectangle& view) const
+{
+    const BouncePool& p {m_knockback};
+    const vec2<int> scroll {static_cast<int>(view.x), static_cast<int>(view.y)};
+    for (std::size_t i{0}; i < p.size(); ++i)
+    {
+        if (CheckCollisionPointRec({p.x[i], p.y[i]}, view))
         {
-            delete p;
-            m_particles[i] = nullptr;
-        } else {
-            renderCinder(p, scroll);
+            const Color c {p.color[i]};
+            DrawPixel(static_cast<int>(p.x[i]) - scroll.x, static_cast<int>(p.y[i]) - scroll.y, {c.r, c.g, c.b, static_cast<unsigned char>(static_cast<int>(p.life[i] / KNOCKBACK_SIZE * 255.f))});
         }
     }
-
-    m_particles.erase(std::remove_if(m_particles.begin(), m_particles.end(), [](Cinder* p){return p == nullptr;}), m_particles.end());
 }
 
-void CinderManager::renderCinder(Cinder* cinder, const vec2<int> scroll)
+void ParticleEngine::renderCinders(const Rectangle& view) const
 {
-    constexpr float scale{3.0f}; // scale of cinder
-    constexpr float width{0.2f}; // width between kite wings
-    constexpr float snout{0.75f}; // ratio between snout and tail
-
-    const float angle {std::atan2(cinder->vel.y, cinder->vel.x)};
-
-    BeginBlendMode(BLEND_ADD_COLORS);
-
-    // weird polygon rendering
-    rlSetTexture(m_blank->id);
-    rlBegin(RL_TRIANGLES);
+    const BouncePool& p {m_cinders};
+    const float scrollX {static_cast<float>(static_cast<int>(view.x))};
+    const float scrollY {static_cast<float>(static_cast<int>(view.y))};
 
-    rlColor4ub(cinder->color.r, cinder->color.g, cinder->color.b, static_cast<unsigned char>(static_cast<int>(cinder->size / m_startSize * 250.f)));
-
-    rlTexCoord2f(0.5f, 0.5f);
-
-    rlVertex2f(cinder->pos.x - static_cast<float>(scroll.x), cinder->pos.y - static_cast<float>(scroll.y));
-    rlVertex2f(cinder->pos.x - static_cast<float>(scroll.x) - std::cos(angle + M_PI * 0.5f), cinder->pos.y - static_cast<float>(scroll.y) - std::sin(angle + M_PI * 0.5f));
-    rlVertex2f(cinder->pos.x - static_cast<float>(scroll.x) - cinder->vel.x * 3.f, cinder->pos.y - static_cast<float>(scroll.y) - cinder->vel.y * 3.f);
-    rlVertex2f(cinder->pos.x - static_cast<float>(scroll.x), cinder->pos.y - static_cast<float>(scroll.y));
-    rlVertex2f(cinder->pos.x - static_cast<float>(scroll.x) - std::cos(angle + M_PI * -0.5f), cinder->pos.y - static_cast<float>(scroll.y) - std::sin(angle + M_PI * -0.5f));
-    rlVertex2f(cinder->pos.x - static_cast<float>(scroll.x) - cinder->vel.x * 3.f, cinder->pos.y - static_cast<float>(scroll.y) - cinder->vel.y * 3.f);
-
-    rlEnd();
-    rlSetTexture(0);
+    // one blend mode and one triangle batch for all of them
+    bool begun {false};
+    for (std::size_t i{0}; i < p.size(); ++i)
+    {
+        // the tail trails three frames of velocity behind, the wings stick out a pixel
+        const float reach {std::max(std::abs(p.velX[i]), std::abs(p.velY[i])) * 3.f + 1.f};
+        if (!Util::inView(view, {p.x[i] - reach, p.y[i] - reach, reach * 2.f, reach * 2.f}))
+        {
+            continue;
+        }
+        if (!begun)
+        {
+            BeginBlendMode(BLEND_ADD_COLORS);
+            rlSetTexture(m_blank->id);
+            rlBegin(RL_TRIANGLES);
+            rlTexCoord2f(0.5f, 0.5f);
+            begun = true;
+            ++DBG::cinderDrawCalls;
+        }
+        // a full batch buffer gets flushed, which costs another draw call
+        if (rlCheckRenderBatchLimit(6))
+        {
+            ++DBG::cinderDrawCalls;
+        }
 
-    EndBlendMode();
+        // wings a pixel out either side of the direction of travel
+        const float speed {std::sqrt(p.velX[i] * p.velX[i] + p.velY[i] * p.velY[i])};
+        const float dx {speed > 0.0f ? p.velX[i] / speed : 1.f};
+        const float dy {speed > 0.0f ? p.velY[i] / speed : 0.f};
+        const float px {p.x[i] - scrollX};
+        const float py {p.y[i] - scrollY};
+        const float tailX {px - p.velX[i] * 3.f};
+        const float tailY {py - p.velY[i] * 3.f};
+        const Color c {p.color[i]};
+
+        rlColor4ub(c.r, c.g, c.b, static_cast<unsigned char>(static_cast<int>(p.life[i] / CINDER_SIZE * 250.f)));
+
+        rlVertex2f(px, py);
+        rlVertex2f(px + dy, py - dx);
+        rlVertex2f(tailX, tailY);
+        rlVertex2f(px, py);
+        rlVertex2f(px - dy, py + dx);
+        rlVertex2f(tailX, tailY);
+    }
+    if (begun)
+    {
+        rlEnd();
+        rlSetTexture(0);
+        EndBlendMode();
+    }
 }
-
-void CinderManager::addParticle(vec2<float> pos, vec2<float> vel, const Color color)
-{
-    m_particles.emplace_back(new Cinder{pos, vel, m_startSize - Util::random(), color});
-}
\ No newline at end of file
@@ -6,134 +6,216 @@
 #include "vec2.hpp"
 #include "tiles.hpp"
 #include "anim.hpp"
-#include "assets.hpp"
+#include "sparks.hpp"
 
+#include <array>
 #include <vector>
+#include <cstdint>
 
-struct Knockback
+// every pool below keeps one particle per row of parallel arrays, allocated up front for its capacity.
+// a dead particle has the last one moved into its place, adding past capacity drops the particle.
+// update moves everyone in one pass and compacts in a second
+
+// tiny bits that bounce off the terrain and fade (knockback pixels, cinders)
+struct BounceParams
 {
-    vec2<float> pos;
-    vec2<float> vel;
-    float size;
-    Color color;
+    float bounce;
+    float friction;
+    float decay;
+    float gravity;
 };
 
-class KnockbackManager
+class BouncePool
 {
 public:
-    KnockbackManager() = default;
-    ~KnockbackManager();
+    BouncePool(std::size_t capacity, const BounceParams& params);
 
-    void free();
+    void clear();
+    void update(float dt, const World* world);
+    bool add(vec2<float> pos, vec2<float> vel, float startLife, Color tint);
 
-    void update(float dt, const vec2<int>& scroll, World* world);
+    [[nodiscard]] std::size_t size() const {return x.size();}
+    [[nodiscard]] std::size_t getCapacity() const {return m_capacity;}
 
-    void addParticle(vec2<float> pos, vec2<float> vel, Color color);
+    std::vector<float> x{};
+    std::vector<float> y{};
+    std::vector<float> velX{};
+    std::vector<float> velY{};
+    std::vector<float> life{}; // fades out as it runs down
+    std::vector<Color> color{};
 
 private:
-    std::vector<Knockback*> m_particles{};
-    const float m_startSize{8.f};
+    std::size_t m_capacity;
+    BounceParams m_params;
+    // indices of particles that moved into terrain this pass
+    std::vector<std::uint32_t> m_hits{};
 };
 
-struct Smoke
-{
-    vec2<float> pos;
-    vec2<float> vel;
-    float targetAngle;
-    float angle;
-    float size;
-};
-
-class SmokeManager
+class SmokePool
 {
 public:
-    SmokeManager() = default;
-    ~SmokeManager();
+    explicit SmokePool(std::size_t capacity);
 
-    void free();
-    void update(float dt, vec2<int> scroll);
+    void clear();
+    void update(float dt);
+    void render(const Rectangle& view) const;
+    bool add(vec2<float> pos, vec2<float> vel);
 
-    void addSmoke(vec2<float> pos, vec2<float> vel);
+    [[nodiscard]] std::size_t size() const {return x.size();}
+    [[nodiscard]] std::size_t getCapacity() const {return m_capacity;}
 
-private:
-    std::vector<Smoke*> m_smoke{};
-    const float m_startSize{10.f};
-};
+    std::vector<float> x{};
+    std::vector<float> y{};
+    std::vector<float> velX{};
+    std::vector<float> velY{};
+    std::vector<float> targetAngle{};
+    std::vector<float> angle{};
+    std::vector<float> life{}; // grows the puff and fades it as it runs down
 
-struct Shockwave
-{
-    vec2<float> center;
-    float targetRadius;
+private:
+    static constexpr float START_SIZE {10.f};
 
-    float innerRadius{0.0f};
-    float outerRadius{0.0f};
+    std::size_t m_capacity;
 };
 
-class ShockwaveManager
+class ShockwavePool
 {
 public:
-    ShockwaveManager() = default;
-    ~ShockwaveManager();
+    explicit ShockwavePool(std::size_t capacity);
 
-    void free();
-    void update(float dt, vec2<int> scroll);
+    void clear();
+    void update(float dt);
+    void render(const Rectangle& view) const;
+    bool add(vec2<float> center, float targetRadius);
 
-    void addShockwave(vec2<float> pos, float targetRadius);
+    [[nodiscard]] std::size_t size() const {return x.size();}
+    [[nodiscard]] std::size_t getCapacity() const {return m_capacity;}
 
-private:
-    std::vector<Shockwave*> m_shockwaves{};
-};
+    std::vector<float> x{};
+    std::vector<float> y{};
+    std::vector<float> targetRadius{};
+    std::vector<float> innerRadius{};
+    std::vector<float> outerRadius{};
 
-struct Flame
-{
-    vec2<float> pos;
-    vec2<float> vel;
-    Anim* anim;
+private:
+    std::size_t m_capacity;
 };
 
-class FlameManager
+class FlamePool
 {
 public:
-    FlameManager(AssetManager* assets);
-    ~FlameManager();
+    explicit FlamePool(std::size_t capacity);
 
-    void free();
-    void update(float dt, vec2<int> scroll);
+    void clear();
+    void update(float dt, const AnimSet* anims);
+    void render(const Rectangle& view, const AnimSet* anims) const;
+    bool add(vec2<float> pos, vec2<float> vel, const AnimState& anim);
 
-    void explode(vec2<float> pos, float intensity);
+    [[nodiscard]] std::size_t size() const {return x.size();}
+    [[nodiscard]] std::size_t getCapacity() const {return m_capacity;}
 
-private:
-    Texture2D* m_flameTex;
+    std::vector<float> x{};
+    std::vector<float> y{};
+    std::vector<float> velX{};
+    std::vector<float> velY{};
+    std::vector<AnimState> anim{};
 
-    std::vector<Flame*> m_flames{};
+private:
+    std::size_t m_capacity;
 };
 
-struct Cinder
+enum ParticleType
 {
-    vec2<float> pos;
-    vec2<float> vel;
-    float size;
-    Color color;
+    PARTICLE_SPARK,
+    PARTICLE_KNOCKBACK,
+    PARTICLE_SMOKE,
+    PARTICLE_SHOCKWAVE,
+    PARTICLE_FLAME,
+    PARTICLE_CINDER,
+    NUM_PARTICLE_TYPES
 };
 
-class CinderManager
+// every vfx particle the entities spawn, one pool per type. nothing is allocated after construction
+//
+// emission is governed by frame time: emitters off screen are culled first, then over budget the
+// emission scale comes down until the frame fits and creeps back up once there's room. each type's
+// PRIORITY decides how much of that scale it takes, 0 takes all of it and 1 is never scaled
+class ParticleEngine
 {
 public:
-    CinderManager(AssetManager* assets);
-    ~CinderManager();
+    // most particles alive at once per type
+    static constexpr std::array<std::size_t, NUM_PARTICLE_TYPES> CAPACITY {32768, 32768, 16384, 1024, 16384, 16384};
+    // default for the most particles alive at once over every type, only priority 1 types emit past it
+    static constexpr std::size_t LIVE_CAP {65536};
+    static constexpr std::array<float, NUM_PARTICLE_TYPES> PRIORITY {0.5f, 0.0f, 0.0f, 1.0f, 0.5f, 0.25f};
+    static constexpr float FRAME_BUDGET {12.f}; // ms of simulate + render
+
+    ParticleEngine() = default;
 
-    void free();
+    // textures / clips for drawing and flame lifetimes. anims is enough to simulate headless
+    void init(const AnimSet* anims, const Texture2D* blank);
+    void clear();
 
-    void update(float dt, vec2<int> scroll, World* world);
+    void update(float dt, const World* world);
+    void render(const Rectangle& view) const;
 
-    void renderCinder(Cinder* cinder, vec2<int> scroll);
+    void addSpark(vec2<float> pos, float angle, float speed);
+    void addKnockback(vec2<float> pos, vec2<float> vel, Color color);
+    void addSmoke(vec2<float> pos, vec2<float> vel);
+    void addShockwave(vec2<float> center, float targetRadius);
+    void addCinder(vec2<float> pos, vec2<float> vel, Color color);
+    // burst of flames around pos
+    void explode(vec2<float> pos, float intensity);
 
-    void addParticle(vec2<float> pos, vec2<float> vel, Color color);
+    // frameMs is how long the last frame's simulate + render took
+    void govern(float dt, float frameMs);
+    // anything up to the sum of CAPACITY, stress tests lift it to see the pools full
+    void setLiveCap(std::size_t cap) {m_liveCap = cap;}
+    [[nodiscard]] std::size_t getLiveCap() const {return m_liveCap;}
+    // emitters further than EMITTER_MARGIN outside the view are culled
+    void setView(const Rectangle& view) {m_view = view;}
+    // false (and counted as culled) if an emitter at pos isn't worth spawning anything for
+    bool shouldEmit(vec2<float> pos);
+    // how many of `count` particles of a type to actually emit
+    [[nodiscard]] int emitCount(ParticleType type, float count) const;
+
+    [[nodiscard]] float getScale() const {return m_scale;}
+    // smoothed
+    [[nodiscard]] float getFrameMs() const {return m_frameMs;}
+    // emitters skipped for being off screen since the last clear
+    [[nodiscard]] std::size_t getCulled() const {return m_culled;}
+
+    [[nodiscard]] std::size_t getCount(ParticleType type) const;
+    [[nodiscard]] std::size_t getCount() const;
+    // particles that didn't fit since the last clear
+    [[nodiscard]] std::size_t getDropped() const {return m_dropped;}
 
 private:
-    Texture2D* m_blank;
-    std::vector<Cinder*> m_particles{};
-    const float m_startSize{8.f};
+    void renderKnockback(const Rectangle& view) const;
+    void renderCinders(const Rectangle& view) const;
+
+    static constexpr float KNOCKBACK_SIZE {8.f};
+    static constexpr float CINDER_SIZE {8.f};
+    static constexpr float MIN_SCALE {0.1f};
+    static constexpr float EMITTER_MARGIN {64.f};
+
+    const AnimSet* m_anims{nullptr};
+    const Texture2D* m_blank{nullptr};
+
+    SparkPool m_sparks{CAPACITY[PARTICLE_SPARK]};
+    BouncePool m_knockback{CAPACITY[PARTICLE_KNOCKBACK], {0.6f, 0.99f, 0.02f, 0.16f}};
+    SmokePool m_smoke{CAPACITY[PARTICLE_SMOKE]};
+    ShockwavePool m_shockwaves{CAPACITY[PARTICLE_SHOCKWAVE]};
+    FlamePool m_flames{CAPACITY[PARTICLE_FLAME]};
+    BouncePool m_cinders{CAPACITY[PARTICLE_CINDER], {0.7f, 0.99f, 0.1f, 0.1f}};
+
+    std::size_t m_dropped{0};
+
+    Rectangle m_view{};
+    std::size_t m_liveCap{LIVE_CAP};
+    float m_scale{1.f};
+    float m_frameMs{0.0f};
+    std::size_t m_culled{0};
 };
 
-#endif
\ No newline at end of file
+#endif
@@ -0,0 +1,251 @@
+#include "physics.hpp"
+#include "constants.hpp"
+
+#include <cmath>
+#include <algorithm>
+
+namespace
+{
+    constexpr float TILE {static_cast<float>(CST::TILE_SIZE)};
+
+    bool columnSolid(const World* world, const int x, const int y0, const int y1)
+    {
+        for (int y{y0}; y <= y1; ++y)
+        {
+            if (world->isSolid(x, y))
+            {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    bool rowSolid(const World* world, const int y, const int x0, const int x1)
+    {
+        for (int x{x0}; x <= x1; ++x)
+        {
+            if (world->isSolid(x, y))
+            {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    // edges are exclusive like CheckCollisionRecs, tiles the body already overlaps are ignored so it can walk out of them
+    void sweepX(PhysicsBody& body, const float dx, const World* world)
+    {
+        if (dx == 0.0f)
+        {
+            return;
+        }
+        const int y0 {static_cast<int>(std::floor(body.pos.y / TILE))};
+        const int y1 {static_cast<int>(std::ceil((body.pos.y + static_cast<float>(body.dimensions.y)) / TILE)) - 1};
+        if (dx > 0.0f)
+        {
+            const float edge {body.pos.x + static_cast<float>(body.dimensions.x)};
+            const int last {static_cast<int>(std::ceil((edge + dx) / TILE)) - 1};
+            for (int x{static_cast<int>(std::ceil(edge / TILE))}; x <= last; ++x)
+            {
+                if (columnSolid(world, x, y0, y1))
+                {
+                    body.pos.x = static_cast<float>(x) * TILE - static_cast<float>(body.dimensions.x);
+                    body.vel.x = 0.0f;
+                    body.hitWall = true;
+                    return;
+                }
+            }
+        } else {
+            const int last {static_cast<int>(std::floor((body.pos.x + dx) / TILE))};
+            for (int x{static_cast<int>(std::floor(body.pos.x / TILE)) - 1}; x >= last; --x)
+            {
+                if (columnSolid(world, x, y0, y1))
+                {
+                    body.pos.x = static_cast<float>(x + 1) * TILE;
+                    body.vel.x = 0.0f;
+                    body.hitWall = true;
+                    return;
+                }
+            }
+        }
+        body.pos.x += dx;
+    }
+
+    void sweepY(PhysicsBody& body, const float dy, const World* world)
+    {
+        if (dy == 0.0f)
+        {
+            return;
+        }
+        const int x0 {static_cast<int>(std::floor(body.pos.x / TILE))};
+        const int x1 {static_cast<int>(std::ceil((body.pos.x + static_cast<float>(body.dimensions.x)) / TILE)) - 1};
+        if (dy > 0.0f)
+        {
+            const float edge {body.pos.y + static_cast<float>(body.dimensions.y)};
+            const int last {static_cast<int>(std::ceil((edge + dy) / TILE)) - 1};
+            for (int y{static_cast<int>(std::ceil(edge / TILE))}; y <= last; ++y)
+            {
+                if (rowSolid(world, y, x0, x1))
+                {
+                    body.pos.y = static_cast<float>(y) * TILE - static_cast<float>(body.dimensions.y);
+                    body.vel.y = 0.0f;
+                    body.landed = true;
+                    return;
+                }
+            }
+        } else {
+            const int last {static_cast<int>(std::floor((body.pos.y + dy) / TILE))};
+            for (int y{static_cast<int>(std::floor(body.pos.y / TILE)) - 1}; y >= last; --y)
+            {
+                if (rowSolid(world, y, x0, x1))
+                {
+                    body.pos.y = static_cast<float>(y + 1) * TILE;
+                    body.vel.y = 0.0f;
+                    return;
+                }
+            }
+        }
+        body.pos.y += dy;
+    }
+
+    bool solidAt(const World* world, const float x, const float y)
+    {
+        return world->isSolid(static_cast<int>(std::floor(x / TILE)), static_cast<int>(std::floor(y / TILE)));
+    }
+
+    float decay(const float offset, const float amount)
+    {
+        if (offset > 0.0f)
+        {
+            return std::max(0.0f, offset - amount);
+        }
+        return std::min(0.0f, offset + amount);
+    }
+}
+
+void Physics::integrate(PhysicsBody* bodies, const std::size_t count, const float dt)
+{
+    for (std::size_t i{0}; i < count; ++i)
+    {
+        PhysicsBody& body {bodies[i]};
+        // take acount for deltatime with friction calculation
+        body.vel.x += (body.vel.x * body.friction - body.vel.x) * dt;
+        body.vel.y += body.gravity * dt;
+        body.vel.y = std::min(body.vel.y, body.maxVelY);
+    }
+}
+
+void Physics::move(PhysicsBody* bodies, const std::size_t count, const float dt, const World* world)
+{
+    const float levelWidth {world->getPixelWidth()};
+    const float levelHeight {world->getPixelHeight()};
+    for (std::size_t i{0}; i < count; ++i)
+    {
+        PhysicsBody& body {bodies[i]};
+        body.landed = false;
+        body.hitWall = false;
+
+        // frame movement = velocity + offset (knockback)
+        const vec2<float> movement {(body.vel.x + body.offset.x) * dt, (body.vel.y + body.offset.y) * dt};
+
+        sweepX(body, movement.x, world);
+        // keep body in level
+        if (body.pos.x < 0.0f)
+        {
+            body.pos.x = 0.0f;
+            body.vel.x = 0.0f;
+        } else if (body.pos.x + static_cast<float>(body.dimensions.x) > levelWidth)
+        {
+            body.pos.x = levelWidth - static_cast<float>(body.dimensions.x);
+        }
+
+        sweepY(body, movement.y, world);
+        if (static_cast<int>(body.pos.y) + body.dimensions.y > levelHeight)
+        {
+            body.pos.y = levelHeight - static_cast<float>(body.dimensions.y);
+        }
+
+        body.offset.x = decay(body.offset.x, body.offsetDecay * dt);
+        body.offset.y = decay(body.offset.y, body.offsetDecay * dt);
+    }
+}
+
+void Physics::snapToGround(PhysicsBody* bodies, const std::size_t count, const float dt, const World* world)
+{
+    const float levelWidth {world->getPixelWidth()};
+    const float levelHeight {world->getPixelHeight()};
+    for (std::size_t i{0}; i < count; ++i)
+    {
+        PhysicsBody& body {bodies[i]};
+        body.landed = false;
+        body.hitWall = false;
+        const float width {static_cast<float>(body.dimensions.x)};
+        const float height {static_cast<float>(body.dimensions.y)};
+
+        body.vel.y = std::min(body.vel.y + body.gravity * dt, body.maxVelY);
+
+        // walk at the speed the tick started with, stopping flush against the first wall the leading edge meets at
+        // half height. a big dt covers more than a tile, so the edge moves a tile at most per check
+        const float x {std::clamp(body.pos.x + (body.vel.x + body.offset.x) * dt, 0.0f, levelWidth - width)};
+        body.vel.x *= std::pow(body.friction, dt);
+        const float middle {body.pos.y + height * 0.5f};
+        const int steps {std::max(1, static_cast<int>(std::ceil(std::abs(x - body.pos.x) / TILE)))};
+        const float stride {(x - body.pos.x) / static_cast<float>(steps)};
+        for (int s{0}; s < steps; ++s)
+        {
+            const float next {s == steps - 1 ? x : body.pos.x + stride};
+            const float edge {stride > 0.0f ? next + width - 0.01f : next};
+            if (solidAt(world, edge, middle))
+            {
+                const float column {std::floor(edge / TILE)};
+                // never backwards, a body that starts inside a wall just stays put
+                body.pos.x = stride > 0.0f ? std::max(body.pos.x, column * TILE - width) : std::min(body.pos.x, (column + 1.0f) * TILE);
+                body.vel.x = 0.0f;
+                body.hitWall = true;
+                break;
+            }
+            body.pos.x = next;
+        }
+
+        const int column {static_cast<int>(std::floor((body.pos.x + width * 0.5f) / TILE))};
+        const float feet {body.pos.y + height};
+        int row {static_cast<int>(std::floor(feet / TILE))};
+        if (world->isSolid(column, row))
+        {
+            // sunk into the floor (walked up a slope), step up a tile at most
+            if (!world->isSolid(column, row - 1))
+            {
+                body.pos.y = static_cast<float>(row) * TILE - height;
+                body.vel.y = 0.0f;
+                body.landed = true;
+            }
+        } else {
+            // falling, land on the first floor within this tick's drop
+            const float fall {std::max(0.0f, (body.vel.y + body.offset.y) * dt)};
+            const int last {static_cast<int>(std::floor((feet + fall) / TILE))};
+            for (++row; row <= last; ++row)
+            {
+                if (world->isSolid(column, row))
+                {
+                    body.pos.y = static_cast<float>(row) * TILE - height;
+                    body.vel.y = 0.0f;
+                    body.landed = true;
+                    break;
+                }
+            }
+            if (!body.landed)
+            {
+                body.pos.y += fall;
+            }
+        }
+        if (body.pos.y + height > levelHeight)
+        {
+            body.pos.y = levelHeight - height;
+            body.vel.y = 0.0f;
+            body.landed = true;
+        }
+
+        body.offset.x = decay(body.offset.x, body.offsetDecay * dt);
+        body.offset.y = decay(body.offset.y, body.offsetDecay * dt);
+    }
+}
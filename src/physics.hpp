@@ -0,0 +1,55 @@
+#ifndef PHYSICS_H
+#define PHYSICS_H
+
+#include "vec2.hpp"
+#include "tiles.hpp"
+
+#include <cstddef>
+
+// axis aligned box that moves through the level (player, enemies)
+struct PhysicsBody
+{
+    vec2<float> pos;
+    vec2<int> dimensions;
+    vec2<float> vel{};
+    vec2<float> offset{}; // knockback / recoil, added on top of vel and decays back to 0
+
+    // tuning
+    float gravity{0.15f};
+    float friction{0.75f};
+    float maxVelY{8.0f};
+    float offsetDecay{0.3f};
+
+    // what the last Physics::move ran into
+    bool landed{false};
+    bool hitWall{false};
+
+    [[nodiscard]] Rectangle getRect() const
+    {
+        return Rectangle{pos.x, pos.y, static_cast<float>(dimensions.x), static_cast<float>(dimensions.y)};
+    }
+};
+
+// solver for arrays of bodies, everything that moves goes through here so a whole step can be batched
+namespace Physics
+{
+    // friction, gravity and the fall speed cap
+    void integrate(PhysicsBody* bodies, std::size_t count, float dt);
+
+    // move by (vel + offset) * dt one axis at a time, sweeping the leading edge across the tile grid so nothing
+    // tunnels at any speed, then keep the bodies in the level and decay their offsets
+    void move(PhysicsBody* bodies, std::size_t count, float dt, const World* world);
+
+    inline void step(PhysicsBody* bodies, const std::size_t count, const float dt, const World* world)
+    {
+        integrate(bodies, count, dt);
+        move(bodies, count, dt, world);
+    }
+
+    // cheap stand-in for step, for bodies nobody can see. stops at walls, steps up one tile and drops onto
+    // the floor under the body's center instead of sweeping every edge. friction is applied exactly, so it
+    // holds up with the big dt of an occasional tick
+    void snapToGround(PhysicsBody* bodies, std::size_t count, float dt, const World* world);
+}
+
+#endif
@@ -2,38 +2,28 @@
 #include "constants.hpp"
 
 Player::Player(const vec2<float> pos, const vec2<int> dimensions)
- : m_pos{pos}, m_dimensions{dimensions}
+ : m_body{pos, dimensions}
 {
-}
-
-Player::~Player()
-{
-    free();
+    // heavier and snappier than the enemies
+    m_body.gravity = 0.25f;
+    m_body.friction = 0.67f;
+    m_body.offsetDecay = 0.5f;
 }
 
 void Player::loadAnim(AssetManager* assets)
 {
-    m_idleAnim = new Anim{9, 14, 6, 0.2f, true, assets->getTexture("player/idle")};
-    m_runAnim = new Anim{9, 14, 10, 0.35f, true, assets->getTexture("player/run")};
-    m_jumpAnim = new Anim{9, 14, 1, 0.1f, true, assets->getTexture("player/jump")};
-    m_landAnim = new Anim{9, 14, 8, 0.5f, false, assets->getTexture("player/land")};
-    m_damageAnim = new Anim{9, 14, 14, 1.0f, true, assets->getTexture("player/damage")};
+    m_anims = assets->getAnims();
+    m_anim = AnimState{0.0f, CLIP_PLAYER_IDLE};
     std::cout << "Loaded animations!\n";
-
-    m_anim = m_idleAnim;
 }
 
 void Player::update(const float dt, World* world)
 {
     // movement constants
-    constexpr float gravity {0.25f};
-    constexpr float friction {0.67f};
     constexpr float speed {1.0f};
     constexpr float jumpBuf {10.f}; // 0.25s
     constexpr float fallBuf {5.f};
     constexpr float jumpHeight {3.5f};
-    constexpr float maxVelY {8.f};
-    constexpr float offsetDecay {0.5f};
 
     m_falling += dt;
     m_jumping += dt;
@@ -43,148 +33,68 @@ void Player::update(const float dt, World* world)
     // x velocity
     if (m_controller.getControl(C_RIGHT))
     {
-        m_vel.x += speed * dt;
+        m_body.vel.x += speed * dt;
         m_flipped = false;
     }
     if (m_controller.getControl(C_LEFT))
     {
-        m_vel.x -= speed * dt;
+        m_body.vel.x -= speed * dt;
         m_flipped = true;
     }
-    m_vel.x += (m_vel.x * friction - m_vel.x) * dt;
 
-    // y velocity
-    m_vel.y += gravity * dt;
-    m_vel.y = std::min(maxVelY, m_vel.y);
+    // friction + gravity
+    Physics::integrate(&m_body, 1, dt);
     if (m_jumping < jumpBuf)
     {
         if (m_falling < fallBuf)
         {
             // jump!
-            m_vel.y = -jumpHeight;
+            m_body.vel.y = -jumpHeight;
             // can't jump anymore buddy
             m_falling = fallBuf + 1.0f;
             m_jumping = jumpBuf + 1.0f;
         }
     }
 
-    vec2<float> movement{m_vel.x * dt + m_offset.x * dt, m_vel.y * dt + m_offset.y * dt};
-
-    m_pos.x += movement.x;
-
-    std::array<Rectangle, 9> rects{};
-    world->getTilesAroundPos(getCenter(), rects);
-
-    // check collisions
-    for (const Rectangle& rect : rects)
-    {
-        // check if we collided with tile
-        if (CheckCollisionRecs(rect, getRect()))
-        {
-            // player was moving left?
-            if (movement.x < 0.0f)
-            {
-                m_pos.x = rect.x + rect.width; // back bro off
-            } else { // hmm must be moving right
-                m_pos.x = rect.x - m_dimensions.x; // just squidge in there...
-            }
-            m_vel.x = 0.0f; // STOP!
-        }
-    }
-
-    // keep player in level
-    if (m_pos.x < 0.0f)
+    Physics::move(&m_body, 1, dt, world);
+    if (m_body.landed)
     {
-        m_pos.x = 0.0f;
-        m_vel.x = 0.0f;
-    } else if (m_pos.x + m_dimensions.x > CST::LEVEL_WIDTH * CST::CHUNK_SIZE * CST::TILE_SIZE)
-    {
-        m_pos.x = CST::LEVEL_WIDTH * CST::CHUNK_SIZE * CST::TILE_SIZE - m_dimensions.x;
-    }
-
-    m_pos.y += movement.y;
-    world->getTilesAroundPos(getCenter(), rects);
-    // same for y motion
-    for (const Rectangle& rect : rects)
-    {
-        // check if we collided with tile
-        if (CheckCollisionRecs(rect, getRect()))
-        {
-            // player was moving up?
-            if (movement.y < 0.0f)
-            {
-                m_pos.y = rect.y + rect.height; // back bro off
-            } else { // hmm must be pelting from the sky
-                m_pos.y = rect.y - m_dimensions.y; // do a nice balancing act
-                m_falling = 0.0f; // reset falling
-            }
-            m_vel.y = 0.0f; // STOP!
-        }
-    }
-
-    // keep player in level
-    if (static_cast<int>(m_pos.y) + m_dimensions.y > CST::LEVEL_HEIGHT * CST::CHUNK_SIZE * CST::TILE_SIZE)
-    {
-        m_pos.y = CST::LEVEL_HEIGHT * CST::CHUNK_SIZE * CST::TILE_SIZE - m_dimensions.y;
+        m_falling = 0.0f; // reset falling
     }
 
     // update animation
     handleAnimations(dt, fallBuf);
-
-    // update offset
-    if (m_offset.x > 0.f)
-    {
-        m_offset.x = std::max(0.f, m_offset.x - offsetDecay * dt);
-    } else if (m_offset.x < 0.f) {
-        m_offset.x = std::min(0.f, m_offset.x + offsetDecay * dt);
-    }
-
-    if (m_offset.y > 0.f)
-    {
-        m_offset.y = std::max(0.f, m_offset.y - offsetDecay * dt);
-    } else if (m_offset.x < 0.f) {
-        m_offset.y = std::min(0.f, m_offset.y + offsetDecay * dt);
-    }
 }
 
 void Player::handleAnimations(const float dt, const float fallBuf)
 {
     // update animation
+    AnimClipId clip {CLIP_PLAYER_IDLE};
     if (m_falling > fallBuf)
     {
-        m_anim = m_jumpAnim;
-        m_runAnim->reset();
-        m_idleAnim->reset();
-        m_landAnim->reset();
+        clip = CLIP_PLAYER_JUMP;
         m_grounded = false;
     } else if (m_controller.getControl(C_RIGHT) || m_controller.getControl(C_LEFT))
     {
-        m_anim = m_runAnim;
-        m_landAnim->reset();
-        m_idleAnim->reset();
-        m_jumpAnim->reset();
+        clip = CLIP_PLAYER_RUN;
     } else if (!m_grounded)
     {
-        m_anim = m_landAnim;
-        m_runAnim->reset();
-        m_idleAnim->reset();
-        m_jumpAnim->reset();
-        if (m_landAnim->getFinished())
+        clip = CLIP_PLAYER_LAND;
+        if (m_anim.clip == CLIP_PLAYER_LAND && m_anims->getFinished(m_anim))
         {
             m_grounded = true;
         }
-    } else
-    {
-        m_anim = m_idleAnim;
     }
 
     if (m_recovery < m_recoveryTime - 8.f)
     {
-        m_anim = m_damageAnim;
+        clip = CLIP_PLAYER_DAMAGE;
     }
 
-    m_anim->tick(dt);
-    m_anim->setFlipped(m_flipped);
+    // switching clips starts the new one from the top
+    m_anim.play(clip);
+    m_anims->tick(&m_anim, 1, dt);
+    m_anim.flipped = m_flipped;
 }
 
 void Player::jump()
@@ -196,25 +106,16 @@ void Player::draw(const vec2<int>& scroll)
 {
     Rectangle rect {getRect()};
     // DrawRectangle(rect.x - scroll.x, rect.y - scroll.y, rect.width, rect.height, RED);
-    m_anim->render({m_pos.x - 1.0f, m_pos.y}, scroll);
-}
-
-void Player::free()
-{
-    delete m_idleAnim;
-    delete m_runAnim;
-    delete m_jumpAnim;
-    delete m_landAnim;
-    delete m_damageAnim;
-    std::cout << "Freed animations!\n";
+    m_anims->render(m_anim, {m_body.pos.x - 1.0f, m_body.pos.y}, scroll);
 }
 
-void Player::damage(float amount, float& screenShake)
+bool Player::damage(float amount)
 {
     if (m_recovery > m_recoveryTime)
     {
         m_health -= amount;
         m_recovery = 0.0f;
-        screenShake = std::max(screenShake, 12.f);
+        return true;
     }
+    return false;
 }
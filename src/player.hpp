@@ -5,6 +5,7 @@
 
 #include "vec2.hpp"
 #include "tiles.hpp"
+#include "physics.hpp"
 #include "assets.hpp"
 #include "anim.hpp"
 
@@ -34,7 +35,6 @@ class Player
 {
 public:
     Player(vec2<float> pos, vec2<int> dimensions);
-    ~Player();
 
     void loadAnim(AssetManager* assets);
 
@@ -45,23 +45,23 @@ public:
 
     void jump();
 
-    [[nodiscard]] Rectangle getRect() {return Rectangle{m_pos.x, m_pos.y, static_cast<float>(m_dimensions.x), static_cast<float>(m_dimensions.y)};}
+    [[nodiscard]] Rectangle getRect() {return Rectangle{m_body.pos.x, m_body.pos.y, static_cast<float>(m_body.dimensions.x), static_cast<float>(m_body.dimensions.y)};}
     [[nodiscard]] vec2<float> getCenter()
     {
-        return vec2<float>{m_pos.x + static_cast<float>(m_dimensions.x) / 2.0f, m_pos.y + static_cast<float>(m_dimensions.y) / 2.0f};
+        return vec2<float>{m_body.pos.x + static_cast<float>(m_body.dimensions.x) / 2.0f, m_body.pos.y + static_cast<float>(m_body.dimensions.y) / 2.0f};
     }
 
-    [[nodiscard]] const vec2<float>& getPos() const {return m_pos;}
-    [[nodiscard]] const vec2<int>& getDimensions() const {return m_dimensions;}
+    [[nodiscard]] const vec2<float>& getPos() const {return m_body.pos;}
+    [[nodiscard]] const vec2<int>& getDimensions() const {return m_body.dimensions;}
 
     [[nodiscard]] Controller* getController() {return &m_controller;}
 
     [[nodiscard]] float getJumping() const {return m_jumping;}
     [[nodiscard]] float getFalling() const {return m_falling;}
 
-    void setVelX(const float val) {m_vel.x = val;}
-    void setVelY(const float val) {m_vel.y = val;}
-    [[nodiscard]] const vec2<float>& getVel() const {return m_vel;}
+    void setVelX(const float val) {m_body.vel.x = val;}
+    void setVelY(const float val) {m_body.vel.y = val;}
+    [[nodiscard]] const vec2<float>& getVel() const {return m_body.vel;}
 
     [[nodiscard]] bool getFlipped() const {return m_flipped;}
 
@@ -70,36 +70,31 @@ public:
     void setMaxHealth(const float val) {m_maxHealth = val;}
     [[nodiscard]] float getMaxHealth() const {return m_maxHealth;}
 
-    void damage(float amount, float& screenShake);
+    // returns false if the player is still recovering from the last hit
+    bool damage(float amount);
     void setRecovery(const float amount) {m_recovery = amount;}
     [[nodiscard]] bool getRecovered() const {return m_recovery > m_recoveryTime;}
     [[nodiscard]] float getRecovery() const {return m_recovery;}
     [[nodiscard]] float getRecoverTime() const {return m_recoveryTime;}
 
-    void setOffsetX(const float val) {m_offset.x = val;}
-    void setOffsetY(const float val) {m_offset.y = val;}
-    void setOffset(const vec2<float>& val) {m_offset = val;}
-    [[nodiscard]] vec2<float> getOffset() {return m_offset;}
+    void setOffsetX(const float val) {m_body.offset.x = val;}
+    void setOffsetY(const float val) {m_body.offset.y = val;}
+    void setOffset(const vec2<float>& val) {m_body.offset = val;}
+    [[nodiscard]] vec2<float> getOffset() {return m_body.offset;}
 
-    void setPos(const vec2<float> pos) {m_pos = pos;}
+    void setPos(const vec2<float> pos) {m_body.pos = pos;}
 
 private:
-    vec2<float> m_pos;
-    vec2<int> m_dimensions;
-
-    vec2<float> m_vel{0.0f, 0.0f};
+    // pos, size, velocity and recoil offset
+    PhysicsBody m_body;
 
     Controller m_controller{};
 
     float m_jumping{99.0f};
     float m_falling{99.0f};
 
-    Anim* m_idleAnim{nullptr};
-    Anim* m_runAnim{nullptr};
-    Anim* m_jumpAnim{nullptr};
-    Anim* m_landAnim{nullptr};
-    Anim* m_damageAnim{nullptr};
-    Anim* m_anim{nullptr}; // anim to play
+    const AnimSet* m_anims{nullptr};
+    AnimState m_anim{}; // anim to play
 
     bool m_flipped{false};
     bool m_grounded{false};
@@ -109,11 +104,6 @@ private:
 
     float m_recovery{99.f};
     const float m_recoveryTime{30.f};
-
-    vec2<float> m_offset{0.f, 0.f};
-
-    // free animations
-    void free();
 };
 
 #endif
@@ -4,7 +4,8 @@
 #include <raylib.h>
 
 #include "vec2.hpp"
-#include "assets.hpp"  // for blank texture
+#include "util.hpp"
+#include "kernels.hpp"
 
 #include <rlgl.h>
 
@@ -12,118 +13,127 @@
 #include <cmath>
 #include <algorithm>
 
-struct Spark
-{
-    vec2<float> pos;
-    float angle;
-    float speed;
-};
-
-class SparkManager
+// sparks fly straight and slow down until they're gone
+//
+// every spark is a row in parallel arrays, allocated up front for `capacity`. a dead spark has the last one
+// moved into its place, adding past capacity drops the spark
+class SparkPool
 {
 public:
-    explicit SparkManager(AssetManager* assets)
-     : m_blank{assets->getTexture("blank")}
+    explicit SparkPool(const std::size_t capacity)
+     : m_capacity{capacity}
     {
+        Util::reserveAll(capacity, x, y, dirX, dirY, speed);
     }
 
-    // free sparks
-    ~SparkManager()
+    void clear()
     {
-        free();
+        Util::clearAll(x, y, dirX, dirY, speed);
     }
 
-    // free memory used by sparks
-    void free()
-        for (std::size_t i{0}; i < m_sparks.size(); ++i)
-        {
-            delete m_sparks[i];
-            m_sparks[i] = nullptr;
-        }
-        m_sparks.clear();
-    }
-    // update and render sparks
-    void update(const float dt, const vec2<int>& scroll)
-    {
-        // update & render sparks
-        for (std::size_t i{0}; i < m_sparks.size(); ++i)
-        {
-            bool kill {updateSpark(m_sparks[i], dt)};
-            if (!kill)
-            {
-                renderSpark(m_sparks[i], scroll);
-            } else {
-                // free spark
-                delete m_sparks[i];
-                m_sparks[i] = nullptr;
-            }
-        }
-
-        // clear finished sparks
-        m_sparks.erase(std::remove_if(m_sparks.begin(), m_sparks.end(), [](Spark* spark)
-        {
-            return spark == nullptr;
-        }), m_sparks.end());
-    }
-
-    // create new spark
-    void addSpark(vec2<float> pos, float angle, float speed)
-    {
-        m_sparks.emplace_back(new Spark{pos, angle, speed});
-    }
-
-    // returns kill
-    bool updateSpark(Spark* spark, const float dt)
+    // move sparks, no drawing
+    void update(const float dt)
     {
         constexpr float decay{0.2f};
 
-        spark->pos.x += std::cos(spark->angle) * spark->speed * dt;
-        spark->pos.y += std::sin(spark->angle) * spark->speed * dt;
+        const std::size_t count {size()};
+        Kernels::advance(x.data(), dirX.data(), speed.data(), count, dt);
+        Kernels::advance(y.data(), dirY.data(), speed.data(), count, dt);
+        Kernels::add(speed.data(), count, -decay * dt);
 
-        spark->speed -= decay * dt;
-        return spark->speed <= 0.f;
+        for (std::size_t i {Kernels::findDead(speed.data(), 0, size())}; i < size(); i = Kernels::findDead(speed.data(), i, size()))
+        {
+            Util::swapRemove(i, x, y, dirX, dirY, speed);
+        }
     }
 
-    // render spark polygon
-    void renderSpark(Spark* spark, const vec2<int>& scroll)
+    // draw the sparks on screen, every visible spark goes into one triangle batch. the batches submitted are
+    // added to drawCalls, each owner has its own counter on the debug overlay
+    void render(const Rectangle& view, const Texture2D* blank, int& drawCalls) const
     {
         constexpr float scale{2.0f}; // scale of spark
         constexpr float width{0.3f}; // width between kite wings
-        constexpr float snout{0.75f}; // ratio between snout and tail
         constexpr Color color {WHITE};
+        // the wings are the direction turned by +-width * pi
+        const float wingCos {static_cast<float>(std::cos(width * M_PI))};
+        const float wingSin {static_cast<float>(std::sin(width * M_PI))};
 
-        const float size{spark->speed * scale};
-
-        // weird polygon rendering
-        rlSetTexture(m_blank->id);
-        rlBegin(RL_TRIANGLES);
-
-        rlColor4ub(color.r, color.g, color.b, color.a);
+        const float scrollX {static_cast<float>(static_cast<int>(view.x))};
+        const float scrollY {static_cast<float>(static_cast<int>(view.y))};
 
-        rlTexCoord2f(0.5f, 0.5f);
+        bool begun {false};
+        for (std::size_t i{0}; i < size(); ++i)
+        {
+            // the snout is the furthest point, speed * scale * scale out
+            const float reach {speed[i] * 4.f};
+            if (!CheckCollisionRecs(view, {x[i] - reach, y[i] - reach, reach * 2.f, reach * 2.f}))
+            {
+                continue;
+            }
+            if (!begun)
+            {
+                rlSetTexture(blank->id);
+                rlBegin(RL_TRIANGLES);
+                rlColor4ub(color.r, color.g, color.b, color.a);
+                rlTexCoord2f(0.5f, 0.5f);
+                begun = true;
+                ++drawCalls;
+            }
+            // a full batch buffer gets flushed, which costs another draw call
+            if (rlCheckRenderBatchLimit(6))
+            {
+                ++drawCalls;
+            }
 
-        rlVertex2f(spark->pos.x - static_cast<float>(scroll.x), spark->pos.y - static_cast<float>(scroll.y));
-        rlVertex2f(spark->pos.x - static_cast<float>(scroll.x) - std::cos(spark->angle - width * M_PI) * size,
-                   spark->pos.y - static_cast<float>(scroll.y) - std::sin(spark->angle - width * M_PI) * size);
-        rlVertex2f(spark->pos.x - static_cast<float>(scroll.x) + std::cos(spark->angle) * size * scale,
-                   spark->pos.y - static_cast<float>(scroll.y) + std::sin(spark->angle) * size * scale);
-        rlVertex2f(spark->pos.x - static_cast<float>(scroll.x), spark->pos.y - static_cast<float>(scroll.y));
-        rlVertex2f(spark->pos.x - static_cast<float>(scroll.x) + std::cos(spark->angle + width * M_PI) * size,
-                   spark->pos.y - static_cast<float>(scroll.y) + std::sin(spark->angle + width * M_PI) * size);
-        rlVertex2f(spark->pos.x - static_cast<float>(scroll.x) + std::cos(spark->angle) * size * scale,
-                   spark->pos.y - static_cast<float>(scroll.y) + std::sin(spark->angle) * size * scale);
+            const float size{speed[i] * scale};
+            const float px {x[i] - scrollX};
+            const float py {y[i] - scrollY};
+            const float dx {dirX[i]};
+            const float dy {dirY[i]};
+            const float snoutX {px + dx * size * scale};
+            const float snoutY {py + dy * size * scale};
+
+            rlVertex2f(px, py);
+            rlVertex2f(px - (dx * wingCos + dy * wingSin) * size, py - (dy * wingCos - dx * wingSin) * size);
+            rlVertex2f(snoutX, snoutY);
+            rlVertex2f(px, py);
+            rlVertex2f(px + (dx * wingCos - dy * wingSin) * size, py + (dy * wingCos + dx * wingSin) * size);
+            rlVertex2f(snoutX, snoutY);
+        }
+        if (begun)
+        {
+            rlEnd();
+            rlSetTexture(0);
+        }
+    }
 
-        rlEnd();
-        rlSetTexture(0);
+    // returns false if the pool is full
+    bool add(const vec2<float> pos, const float sparkAngle, const float sparkSpeed)
+    {
+        if (size() >= m_capacity)
+        {
+            return false;
+        }
+        x.push_back(pos.x);
+        y.push_back(pos.y);
+        dirX.push_back(std::cos(sparkAngle));
+        dirY.push_back(std::sin(sparkAngle));
+        speed.push_back(sparkSpeed);
+        return true;
     }
 
-    [[nodiscard]] const std::vector<Spark*>& getSparks() const {return m_sparks;}
+    [[nodiscard]] std::size_t size() const {return x.size();}
+    [[nodiscard]] std::size_t getCapacity() const {return m_capacity;}
+
+    std::vector<float> x{};
+    std::vector<float> y{};
+    // cos / sin of the angle it flies at, so neither the update nor the draw needs any trig
+    std::vector<float> dirX{};
+    std::vector<float> dirY{};
+    std::vector<float> speed{};
 
 private:
-    // blank particle texture
-    Texture2D* m_blank;
-    // da sparx
-    std::vector<Spark*> m_sparks{};
+    std::size_t m_capacity;
 };
 
 #endif
@@ -0,0 +1,44 @@
+#include "spatialgrid.hpp"
+
+#include <cmath>
+
+void SpatialGrid::reset(const float width, const float height)
+{
+    m_width = std::max(1, static_cast<int>(std::ceil(width / m_cellSize)));
+    m_height = std::max(1, static_cast<int>(std::ceil(height / m_cellSize)));
+    m_maxWidth = 0.f;
+    m_maxHeight = 0.f;
+    m_items.clear();
+    m_cellStart.clear();
+    m_entries.clear();
+}
+
+void SpatialGrid::add(const Rectangle& rect, const std::uint32_t id)
+{
+    m_items.push_back(Item{rect, id});
+    m_maxWidth = std::max(m_maxWidth, rect.width);
+    m_maxHeight = std::max(m_maxHeight, rect.height);
+}
+
+void SpatialGrid::build()
+{
+    // count, prefix sum, then fill, same as the flow field's reverse edges
+    m_cells.resize(m_items.size());
+    m_cellStart.assign(static_cast<std::size_t>(m_width) * m_height + 1, 0);
+    for (std::size_t i{0}; i < m_items.size(); ++i)
+    {
+        m_cells[i] = cellY(m_items[i].rect.y) * m_width + cellX(m_items[i].rect.x);
+        ++m_cellStart[m_cells[i] + 1];
+    }
+    for (std::size_t i{1}; i < m_cellStart.size(); ++i)
+    {
+        m_cellStart[i] += m_cellStart[i - 1];
+    }
+
+    m_entries.resize(m_items.size());
+    m_fill.assign(m_cellStart.begin(), m_cellStart.end() - 1);
+    for (std::size_t i{0}; i < m_items.size(); ++i)
+    {
+        m_entries[m_fill[m_cells[i]]++] = static_cast<std::uint32_t>(i);
+    }
+}
@@ -0,0 +1,86 @@
+#ifndef SPATIAL_GRID_H
+#define SPATIAL_GRID_H
+
+#include "raylib.h"
+
+#include <vector>
+#include <cstdint>
+#include <algorithm>
+
+// uniform grid of boxes for overlap queries, rebuilt from scratch every tick
+//
+// add() everything, build() buckets each box by the cell its top left corner is in (CSR, like the flow field's
+// edges), then query() looks at the cells the query box touches, grown up and left by the biggest box so
+// nothing that pokes into it is missed. boxes outside the bounds land in the edge cells
+class SpatialGrid
+{
+public:
+    explicit SpatialGrid(float cellSize = 24.f) : m_cellSize{cellSize}, m_invCellSize{1.f / cellSize} {}
+
+    // forget everything and cover width x height pixels from the origin
+    void reset(float width, float height);
+
+    void add(const Rectangle& rect, std::uint32_t id);
+    void build();
+
+    // calls fn(id) for every box that overlaps rect
+    template <typename F>
+    void query(const Rectangle& rect, F&& fn) const
+    {
+        if (m_cellStart.empty())
+        {
+            return;
+        }
+        const int minX {cellX(rect.x - m_maxWidth)};
+        const int maxX {cellX(rect.x + rect.width)};
+        const int minY {cellY(rect.y - m_maxHeight)};
+        const int maxY {cellY(rect.y + rect.height)};
+        for (int y{minY}; y <= maxY; ++y)
+        {
+            for (int e{m_cellStart[y * m_width + minX]}; e < m_cellStart[y * m_width + maxX + 1]; ++e)
+            {
+                const Item& item {m_items[m_entries[e]]};
+                if (overlaps(rect, item.rect))
+                {
+                    fn(item.id);
+                }
+            }
+        }
+    }
+
+    [[nodiscard]] std::size_t getCount() const {return m_items.size();}
+
+private:
+    struct Item
+    {
+        Rectangle rect;
+        std::uint32_t id;
+    };
+
+    // truncating is fine, anything left of / above the origin gets clamped into the first cell anyway
+    [[nodiscard]] int cellX(const float x) const {return std::clamp(static_cast<int>(x * m_invCellSize), 0, m_width - 1);}
+    [[nodiscard]] int cellY(const float y) const {return std::clamp(static_cast<int>(y * m_invCellSize), 0, m_height - 1);}
+
+    // same test as CheckCollisionRecs, but inlined
+    [[nodiscard]] static bool overlaps(const Rectangle& a, const Rectangle& b)
+    {
+        return a.x < b.x + b.width && a.x + a.width > b.x && a.y < b.y + b.height && a.y + a.height > b.y;
+    }
+
+    float m_cellSize;
+    float m_invCellSize;
+    int m_width{0};
+    int m_height{0};
+    float m_maxWidth{0.f};
+    float m_maxHeight{0.f};
+
+    std::vector<Item> m_items{};
+    // items in each cell, m_cellStart[cell] .. m_cellStart[cell + 1] in m_entries
+    std::vector<int> m_cellStart{};
+    std::vector<std::uint32_t> m_entries{};
+    // scratch for build()
+    std::vector<int> m_cells{};
+    std::vector<int> m_fill{};
+};
+
+#endif
@@ -0,0 +1,101 @@
+#include "streamer.hpp"
+#include "tiles.hpp"
+#include "util.hpp"
+
+#include <utility>
+
+ChunkStreamer::~ChunkStreamer()
+{
+    stop();
+}
+
+void ChunkStreamer::start(Loader loader)
+{
+    stop();
+    m_loader = std::move(loader);
+    m_quit = false;
+    m_thread = std::thread{&ChunkStreamer::run, this};
+}
+
+void ChunkStreamer::stop()
+{
+    if (m_thread.joinable())
+    {
+        {
+            std::lock_guard<std::mutex> lock{m_mutex};
+            m_quit = true;
+        }
+        m_wake.notify_one();
+        m_thread.join();
+    }
+
+    for (Chunk* chunk : m_finished)
+    {
+        delete chunk;
+    }
+    m_finished.clear();
+    m_requests.clear();
+    m_pending.clear();
+    m_loader = nullptr;
+}
+
+void ChunkStreamer::request(const int chunkX, const int chunkY)
+{
+    const std::uint64_t key {Util::chunkKey(chunkX, chunkY)};
+    {
+        std::lock_guard<std::mutex> lock{m_mutex};
+        if (!m_pending.insert(key).second)
+        {
+            return;
+        }
+        m_requests.push_back(key);
+    }
+    m_wake.notify_one();
+}
+
+std::size_t ChunkStreamer::getPendingCount()
+{
+    std::lock_guard<std::mutex> lock{m_mutex};
+    return m_pending.size();
+}
+
+void ChunkStreamer::collect(std::vector<Chunk*>& out)
+{
+    std::lock_guard<std::mutex> lock{m_mutex};
+    for (Chunk* chunk : m_finished)
+    {
+        m_pending.erase(Util::chunkKey(chunk->pos.x, chunk->pos.y));
+        out.push_back(chunk);
+    }
+    m_finished.clear();
+}
+
+void ChunkStreamer::run()
+{
+    std::unique_lock<std::mutex> lock{m_mutex};
+    while (true)
+    {
+        m_wake.wait(lock, [this] {return m_quit || !m_requests.empty();});
+        if (m_quit)
+        {
+            return;
+        }
+
+        const std::uint64_t key {m_requests.front()};
+        m_requests.pop_front();
+        const int chunkX {static_cast<int>(static_cast<std::uint32_t>(key >> 32))};
+        const int chunkY {static_cast<int>(static_cast<std::uint32_t>(key))};
+
+        // load without holding the lock so the game thread never waits on the disk
+        lock.unlock();
+        Chunk* chunk {m_loader(chunkX, chunkY)};
+        lock.lock();
+
+        if (chunk != nullptr)
+        {
+            m_finished.push_back(chunk);
+        } else {
+            m_pending.erase(key);
+        }
+    }
+}
@@ -0,0 +1,56 @@
+#ifndef STREAMER_H
+#define STREAMER_H
+
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+#include <deque>
+#include <vector>
+#include <unordered_set>
+#include <cstdint>
+
+struct Chunk;
+
+// loads chunks on a background thread, the World hands out requests and picks up the finished chunks once per frame
+class ChunkStreamer
+{
+public:
+    // builds a chunk from the level data, runs on the streaming thread so it must not touch the gpu
+    using Loader = std::function<Chunk*(int chunkX, int chunkY)>;
+
+    ChunkStreamer() = default;
+    ~ChunkStreamer();
+
+    ChunkStreamer(const ChunkStreamer&) = delete;
+    ChunkStreamer& operator=(const ChunkStreamer&) = delete;
+
+    void start(Loader loader);
+    // join the thread and throw away anything that hasn't been collected
+    void stop();
+
+    [[nodiscard]] bool isRunning() const {return m_thread.joinable();}
+
+    // queue a chunk, does nothing if it's already queued or loading
+    void request(int chunkX, int chunkY);
+    // chunks queued, loading or waiting to be collected
+    [[nodiscard]] std::size_t getPendingCount();
+
+    // move the finished chunks into out (the caller owns them)
+    void collect(std::vector<Chunk*>& out);
+
+private:
+    void run();
+
+    Loader m_loader{};
+    std::thread m_thread{};
+    std::mutex m_mutex{};
+    std::condition_variable m_wake{};
+    bool m_quit{false};
+
+    std::deque<std::uint64_t> m_requests{};
+    std::unordered_set<std::uint64_t> m_pending{}; // queued or loading
+    std::vector<Chunk*> m_finished{};
+};
+
+#endif
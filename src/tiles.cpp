@@ -1,60 +1,200 @@
 #include "tiles.hpp"
 #include "util.hpp"
+#include "debug.hpp"
 
 #include <fstream>
+#include <chrono>
+#include <limits>
 
-Chunk* World::getChunkAt(const float x, const float y)
+World::~World()
 {
-    vec2<int> chunk_loc {static_cast<int>(std::floor(x / (float)CST::TILE_SIZE / (float)CST::CHUNK_SIZE)), static_cast<int>(std::floor(y / (float)CST::TILE_SIZE / (float)CST::CHUNK_SIZE))};
-    if (0 <= chunk_loc.x && chunk_loc.x < CST::LEVEL_WIDTH && 0 <= chunk_loc.y && chunk_loc.y < CST::LEVEL_HEIGHT)
+    // the streaming thread reads the level, so it goes first
+    m_streamer.stop();
+    for (auto& [key, chunk] : m_chunks)
     {
-        int chunk_idx {chunk_loc.y * CST::LEVEL_WIDTH + chunk_loc.x};
-        Chunk* chunk {&(m_chunks[chunk_idx])};
-        return chunk;
+        delete chunk;
     }
-    return nullptr;
+    m_chunks.clear();
+    m_stash.clear();
 }
 
-Tile* World::getTileAt(const float x, const float y)
+Chunk* World::getChunkAt(const float x, const float y)
+{
+    return getChunkAtTile(static_cast<int>(std::floor(x / (float)CST::TILE_SIZE)), static_cast<int>(std::floor(y / (float)CST::TILE_SIZE)));
+}
+
+Chunk* World::getChunkAtTile(const int tileX, const int tileY)
+{
+    const auto it {m_chunks.find(Util::chunkKey(Util::floorDiv(tileX, CST::CHUNK_SIZE), Util::floorDiv(tileY, CST::CHUNK_SIZE)))};
+    return it != m_chunks.end() ? it->second : nullptr;
+}
+
+Tile* World::getTile(const int tileX, const int tileY)
 {
-    Chunk* chunk{getChunkAt(x, y)};
+    Chunk* chunk {getChunkAtTile(tileX, tileY)};
     if (chunk != nullptr)
     {
-        const int tileX {static_cast<int>(std::floor(x / (float)CST::TILE_SIZE))};
-        const int tileY {static_cast<int>(std::floor(y / (float)CST::TILE_SIZE))};
-        std::string key {std::to_string(tileX) + ";" + std::to_string(tileY)};
-        if (chunk->colliders.find(key) != chunk->colliders.end())
+        // position inside the chunk grid
+        const int localX {tileX - Util::floorDiv(tileX, CST::CHUNK_SIZE) * CST::CHUNK_SIZE};
+        const int localY {tileY - Util::floorDiv(tileY, CST::CHUNK_SIZE) * CST::CHUNK_SIZE};
+        const std::uint16_t idx {chunk->grid[localY * CST::CHUNK_SIZE + localX]};
+        if (idx != 0)
         {
-            return chunk->colliders.find(key)->second;
+            return &chunk->tiles[idx - 1];
         }
     }
     return nullptr;
 }
 
-void World::getTilesAroundPos(const vec2<float>& pos, std::array<Rectangle, 9>& rects)
+Tile* World::getTileAt(const float x, const float y)
+{
+    return getTile(static_cast<int>(std::floor(x / (float)CST::TILE_SIZE)), static_cast<int>(std::floor(y / (float)CST::TILE_SIZE)));
+}
+
+bool World::isSolid(const int tileX, const int tileY) const
 {
-    for (auto& e : rects)
+    if (0 <= tileX && tileX < m_widthTiles && 0 <= tileY && tileY < m_heightTiles)
     {
-        // something nothing will hopefully collide with :)
-        e = Rectangle{-99, -99, 1, 1};
+        return (m_solid[static_cast<std::size_t>(tileY) * m_solidStride + (tileX >> 6)] >> (tileX & 63)) & 1;
     }
-    for (int y{0}; y < 3; ++y)
+    return false;
+}
+
+bool World::isSolidAt(const float x, const float y) const
+{
+    return isSolid(static_cast<int>(std::floor(x / (float)CST::TILE_SIZE)), static_cast<int>(std::floor(y / (float)CST::TILE_SIZE)));
+}
+
+std::size_t World::findSolid(const float* xs, const float* ys, const std::size_t count, std::uint32_t* hits) const
+{
+    if (m_solid.empty())
     {
-        for (int x{0}; x < 3; ++x)
+        return 0;
+    }
+    const std::uint64_t* solid {m_solid.data()};
+    const std::size_t stride {static_cast<std::size_t>(m_solidStride)};
+    const unsigned width {static_cast<unsigned>(m_widthTiles)};
+    const unsigned height {static_cast<unsigned>(m_heightTiles)};
+
+    // std::floor is a libm call without sse4.1, truncating and stepping down negatives gives the same tile
+    const auto tile {[](const float pixel) {
+        const float q {pixel / (float)CST::TILE_SIZE};
+        const int t {static_cast<int>(q)};
+        return static_cast<unsigned>(t - (q < static_cast<float>(t)));
+    }};
+
+    // no branches per point: outside the level reads word 0 and masks the bit off, every point is
+    // written to hits and only counted if it's solid
+    std::size_t found{0};
+    for (std::size_t i{0}; i < count; ++i)
+    {
+        const unsigned tileX {tile(xs[i])};
+        const unsigned tileY {tile(ys[i])};
+        const std::uint64_t inside {static_cast<std::uint64_t>(tileX < width && tileY < height)};
+        const std::size_t word {inside != 0 ? tileY * stride + (tileX >> 6) : 0};
+        hits[found] = static_cast<std::uint32_t>(i);
+        found += (solid[word] >> (tileX & 63)) & inside;
+    }
+    return found;
+}
+
+RayHit World::raycast(const vec2<float>& origin, const vec2<float>& dir, const float maxDist) const
+{
+    vec2<int> tile {static_cast<int>(std::floor(origin.x / (float)CST::TILE_SIZE)), static_cast<int>(std::floor(origin.y / (float)CST::TILE_SIZE))};
+    if (isSolid(tile.x, tile.y))
+    {
+        return RayHit{true, origin, tile, {0, 0}, 0.0f};
+    }
+
+    const float length {std::sqrt(dir.x * dir.x + dir.y * dir.y)};
+    if (length <= 0.0f)
+    {
+        return RayHit{};
+    }
+    const vec2<float> d {dir.x / length, dir.y / length};
+
+    constexpr float inf {std::numeric_limits<float>::infinity()};
+    const vec2<int> step {d.x > 0.0f ? 1 : (d.x < 0.0f ? -1 : 0), d.y > 0.0f ? 1 : (d.y < 0.0f ? -1 : 0)};
+    // ray distance to cross a whole tile on each axis
+    const vec2<float> delta {step.x != 0 ? (float)CST::TILE_SIZE / std::abs(d.x) : inf, step.y != 0 ? (float)CST::TILE_SIZE / std::abs(d.y) : inf};
+    // ray distance to the first tile boundary on each axis
+    vec2<float> next {
+        step.x > 0 ? (static_cast<float>((tile.x + 1) * CST::TILE_SIZE) - origin.x) / d.x : (step.x < 0 ? (static_cast<float>(tile.x * CST::TILE_SIZE) - origin.x) / d.x : inf),
+        step.y > 0 ? (static_cast<float>((tile.y + 1) * CST::TILE_SIZE) - origin.y) / d.y : (step.y < 0 ? (static_cast<float>(tile.y * CST::TILE_SIZE) - origin.y) / d.y : inf)
+    };
+
+    while (true)
+    {
+        float t;
+        vec2<int> normal;
+        if (next.x < next.y)
         {
-            Tile* tile {getTileAt(pos.x - CST::TILE_SIZE + CST::TILE_SIZE * x, pos.y - CST::TILE_SIZE + CST::TILE_SIZE * y)};
-            if (tile != nullptr)
-            {
-                if (Util::elementIn<TileType, std::size(SOLID_TILES)>(tile->type, SOLID_TILES.data()))
-                {
-                    rects[y * 3 + x] = Rectangle{static_cast<float>(tile->pos.x * CST::TILE_SIZE), static_cast<float>(tile->pos.y * CST::TILE_SIZE), CST::TILE_SIZE, CST::TILE_SIZE};
-                }
-            }
+            t = next.x;
+            tile.x += step.x;
+            next.x += delta.x;
+            normal = {-step.x, 0};
+        } else {
+            t = next.y;
+            tile.y += step.y;
+            next.y += delta.y;
+            normal = {0, -step.y};
+        }
+        if (t > maxDist)
+        {
+            return RayHit{};
+        }
+        // heading away from the level, nothing left to hit
+        if ((tile.x < 0 && step.x <= 0) || (tile.x >= m_widthTiles && step.x >= 0) || (tile.y < 0 && step.y <= 0) || (tile.y >= m_heightTiles && step.y >= 0))
+        {
+            return RayHit{};
+        }
+        if (isSolid(tile.x, tile.y))
+        {
+            return RayHit{true, {origin.x + d.x * t, origin.y + d.y * t}, tile, normal, t};
+        }
+    }
+}
+
+bool World::lineOfSight(const vec2<float>& a, const vec2<float>& b) const
+{
+    const vec2<float> dir {b.x - a.x, b.y - a.y};
+    return !raycast(a, dir, std::sqrt(dir.x * dir.x + dir.y * dir.y)).hit;
+}
+
+void World::buildSolidBitmap()
+{
+    m_widthTiles = m_widthChunks * CST::CHUNK_SIZE;
+    m_heightTiles = m_heightChunks * CST::CHUNK_SIZE;
+    m_solidStride = (m_widthTiles + 63) / 64;
+    m_solid.assign(static_cast<std::size_t>(m_solidStride) * m_heightTiles, 0);
+
+    // built straight from the packed tiles so collisions never depend on what's streamed in,
+    // `seen` makes the first tile win if the map has duplicates (same as buildChunk)
+    std::vector<std::uint64_t> seen(m_solid.size(), 0);
+    const LevelFile::PackedTile* tiles {m_level.getTiles()};
+    for (std::uint32_t t{0}; t < m_level.getHeader().numTiles; ++t)
+    {
+        const int x {tiles[t].x};
+        const int y {tiles[t].y};
+        if (!(0 <= x && x < m_widthTiles && 0 <= y && y < m_heightTiles))
+        {
+            continue;
+        }
+        const std::size_t word {static_cast<std::size_t>(y) * m_solidStride + (x >> 6)};
+        const std::uint64_t bit {std::uint64_t{1} << (x & 63)};
+        if (seen[word] & bit)
+        {
+            continue;
+        }
+        seen[word] |= bit;
+        if (Util::elementIn<TileType, std::size(SOLID_TILES)>(getTileType(tiles[t].type), SOLID_TILES.data()))
+        {
+            m_solid[word] |= bit;
         }
     }
 }
 
-TileType World::getTileType(const int type)
+TileType World::getTileType(const int type) const
 {
     switch (type)
     {
@@ -67,7 +207,7 @@ TileType World::getTileType(const int type)
     }
 }
 
-DecorType World::getDecorType(const int type)
+DecorType World::getDecorType(const int type) const
 {
     switch (type)
     {
@@ -112,7 +252,7 @@ Rectangle World::getClipRect(const Tile& tile) const
 
 Rectangle World::getDecorClipRect(const Decor& tile) const
 {
-    return Rectangle{static_cast<float>(tile.variant * 32), 0, 32, 32};
+    return Rectangle{static_cast<float>(tile.variant * DECOR_SIZE), 0, DECOR_SIZE, DECOR_SIZE};
 }
 
 void World::renderChunk(Chunk* chunk, const vec2<int>& scroll, AssetManager* assets)
@@ -125,7 +265,7 @@ void World::renderChunk(Chunk* chunk, const vec2<int>& scroll, AssetManager* ass
     }
 }
 
-void World::renderDecorChunk(DecorChunk* chunk, const vec2<int>& scroll, AssetManager* assets)
+void World::renderDecorChunk(Chunk* chunk, const vec2<int>& scroll, AssetManager* assets)
 {
     for (const Decor& tile : chunk->decor)
     {
@@ -136,85 +276,581 @@ void World::renderDecorChunk(DecorChunk* chunk, const vec2<int>& scroll, AssetMa
     }
 }
 
-void World::render(const vec2<int>& scroll, int width, int height, AssetManager* assets)
+ChunkRange World::getChunksInRect(const Rectangle& rect) const
 {
-    int chunkX {static_cast<int>(std::floor(static_cast<float>(scroll.x) / static_cast<float>(CST::TILE_SIZE) / static_cast<float>(CST::CHUNK_SIZE)))};
-    int chunkY {static_cast<int>(std::floor(static_cast<float>(scroll.y) / static_cast<float>(CST::TILE_SIZE) / static_cast<float>(CST::CHUNK_SIZE)))};
-    for (int y{0}; y < std::floor(height / CST::TILE_SIZE) + 1; ++y)
+    constexpr float chunkPixels {static_cast<float>(CST::CHUNK_SIZE * CST::TILE_SIZE)};
+    return ChunkRange{
+        std::max(0, static_cast<int>(std::floor(rect.x / chunkPixels))),
+        std::max(0, static_cast<int>(std::floor(rect.y / chunkPixels))),
+        std::min(m_widthChunks - 1, static_cast<int>(std::ceil((rect.x + rect.width) / chunkPixels)) - 1),
+        std::min(m_heightChunks - 1, static_cast<int>(std::ceil((rect.y + rect.height) / chunkPixels)) - 1)
+    };
+}
+
+void World::render(const Rectangle& view)
+{
+    const vec2<int> scroll {static_cast<int>(view.x), static_cast<int>(view.y)};
+    // baked chunks hang DECOR_SIZE over their right and bottom edges
+    const ChunkRange range {getChunksInRect({view.x - DECOR_SIZE, view.y - DECOR_SIZE, view.width + DECOR_SIZE, view.height + DECOR_SIZE})};
+    for (int y{range.y0}; y <= range.y1; ++y)
     {
-        for (int x{0}; x < std::floor(width / CST::TILE_SIZE) + 1; ++x)
+        for (int x{range.x0}; x <= range.x1; ++x)
         {
-            int targetX {chunkX - 1 + x};
-            int targetY {chunkY - 1 + y};
-            if (0 <= targetX && targetX < CST::LEVEL_WIDTH && 0 <= targetY && targetY < CST::LEVEL_HEIGHT)
+            // empty (or not yet streamed in) chunks have nothing to draw
+            const auto it {m_chunks.find(Util::chunkKey(x, y))};
+            if (it == m_chunks.end() || it->second->cache.id == 0)
             {
-                int chunk_idx{targetY * CST::LEVEL_WIDTH + targetX};
-                DecorChunk* decor {&m_decorChunks[chunk_idx]};
-                renderDecorChunk(decor, scroll, assets);
-                Chunk* chunk {&m_chunks[chunk_idx]};
-                renderChunk(chunk, scroll, assets);
+                continue;
             }
+            const RenderTexture2D& cache {it->second->cache};
+            // render textures are upside down
+            DrawTextureRec(cache.texture, {0.0f, 0.0f, static_cast<float>(cache.texture.width), -static_cast<float>(cache.texture.height)},
+                {static_cast<float>(x * CST::CHUNK_SIZE * CST::TILE_SIZE - scroll.x), static_cast<float>(y * CST::CHUNK_SIZE * CST::TILE_SIZE - scroll.y)}, WHITE);
+            ++DBG::worldDrawCalls;
         }
     }
 }
 
-void World::loadFromFile(const char* path)
+void World::stream(const Rectangle& view)
 {
-    std::ifstream f;
-    f.open(path);
-    if (!f.is_open())
+    // chunks the streaming thread finished since last frame
+    std::vector<Chunk*> loaded{};
+    m_streamer.collect(loaded);
+    for (Chunk* chunk : loaded)
+    {
+        insertChunk(chunk);
+    }
+
+    // same padding as render
+    const ChunkRange visible {getChunksInRect({view.x - DECOR_SIZE, view.y - DECOR_SIZE, view.width + DECOR_SIZE, view.height + DECOR_SIZE})};
+    const ChunkRange wanted {
+        std::max(0, visible.x0 - CST::STREAM_MARGIN),
+        std::max(0, visible.y0 - CST::STREAM_MARGIN),
+        std::min(m_widthChunks - 1, visible.x1 + CST::STREAM_MARGIN),
+        std::min(m_heightChunks - 1, visible.y1 + CST::STREAM_MARGIN)
+    };
+
+    // on screen chunks can't wait for the streaming thread
+    for (int y{visible.y0}; y <= visible.y1; ++y)
+    {
+        for (int x{visible.x0}; x <= visible.x1; ++x)
+        {
+            const std::uint64_t key {Util::chunkKey(x, y)};
+            if (m_chunks.count(key) == 0 && !restoreChunk(key))
+            {
+                insertChunk(buildChunk(x, y));
+            }
+        }
+    }
+
+    // prefetch the margin a ring at a time (nearest first) with whatever budget is left
+    for (int ring{1}; ring <= CST::STREAM_MARGIN; ++ring)
+    {
+        for (int y{wanted.y0}; y <= wanted.y1; ++y)
+        {
+            for (int x{wanted.x0}; x <= wanted.x1; ++x)
+            {
+                const int distance {std::max({visible.x0 - x, x - visible.x1, visible.y0 - y, y - visible.y1})};
+                if (distance != ring || m_chunks.size() + m_streamer.getPendingCount() >= static_cast<std::size_t>(m_chunkBudget))
+                {
+                    continue;
+                }
+                const std::uint64_t key {Util::chunkKey(x, y)};
+                if (m_chunks.count(key) == 0 && !restoreChunk(key) && findEntry(x, y) != nullptr)
+                {
+                    m_streamer.request(x, y);
+                }
+            }
+        }
+    }
+
+    if (m_chunks.size() <= static_cast<std::size_t>(m_chunkBudget))
     {
-        std::cout << "Failed to read from `" << path << "`!\n";
         return;
     }
-    json data = json::parse(f);
-    std::cout << "Parsed json from `" << path << "`!\n";
 
-    for (std::size_t i{0}; i < CST::NUM_CHUNKS; ++i)
+    // over budget, drop the off screen chunks furthest from the camera
+    const float centerX {(static_cast<float>(visible.x0 + visible.x1) + 1.f) * 0.5f};
+    const float centerY {(static_cast<float>(visible.y0 + visible.y1) + 1.f) * 0.5f};
+    std::vector<std::pair<float, std::uint64_t>> candidates{};
+    for (const auto& [key, chunk] : m_chunks)
+    {
+        const vec2<int>& pos {chunk->pos};
+        if (visible.x0 <= pos.x && pos.x <= visible.x1 && visible.y0 <= pos.y && pos.y <= visible.y1)
+        {
+            continue;
+        }
+        const float dx {static_cast<float>(pos.x) + 0.5f - centerX};
+        const float dy {static_cast<float>(pos.y) + 0.5f - centerY};
+        candidates.emplace_back(dx * dx + dy * dy, key);
+    }
+    std::sort(candidates.begin(), candidates.end(), [](const auto& a, const auto& b) {return a.first > b.first;});
+    for (const auto& [distance, key] : candidates)
+    {
+        if (m_chunks.size() <= static_cast<std::size_t>(m_chunkBudget))
+        {
+            break;
+        }
+        evictChunk(key);
+    }
+}
+
+const LevelFile::ChunkEntry* World::findEntry(const int chunkX, const int chunkY) const
+{
+    if (!m_level.isOpen())
+    {
+        return nullptr;
+    }
+    // entries are sorted by (y, x)
+    const LevelFile::ChunkEntry* first {m_level.getChunks()};
+    const LevelFile::ChunkEntry* last {first + m_level.getHeader().numChunks};
+    const LevelFile::ChunkEntry* entry {std::lower_bound(first, last, vec2<int>{chunkX, chunkY}, [](const LevelFile::ChunkEntry& e, const vec2<int>& pos) {
+        return e.y < pos.y || (e.y == pos.y && e.x < pos.x);
+    })};
+    if (entry != last && entry->x == chunkX && entry->y == chunkY)
+    {
+        return entry;
+    }
+    return nullptr;
+}
+
+Chunk* World::buildChunk(const int chunkX, const int chunkY) const
+{
+    const LevelFile::ChunkEntry* entry {findEntry(chunkX, chunkY)};
+    if (entry == nullptr)
     {
-        m_chunks[i] = Chunk{{0, 0}};
-        m_chunks[i].colliders.clear();
-        m_chunks[i].tiles.clear();
+        return nullptr;
     }
 
+    const LevelFile::PackedTile* tiles {m_level.getTiles()};
+    const LevelFile::PackedDecor* decor {m_level.getDecor()};
+    const vec2<int> origin {chunkX * CST::CHUNK_SIZE, chunkY * CST::CHUNK_SIZE};
+
     // handle tiles that are on the grid
-    for (const auto& tile : data["level"]["tiles"])
+    Chunk* chunk {new Chunk{{chunkX, chunkY}}};
+    chunk->tiles.reserve(entry->numTiles);
+    for (std::uint32_t t{entry->firstTile}; t < entry->firstTile + entry->numTiles; ++t)
     {
-        vec2<int> chunk_loc {static_cast<int>(std::floor((float)tile["pos"][0] / (float)CST::CHUNK_SIZE)), static_cast<int>(std::floor((float)tile["pos"][1] / (float)CST::CHUNK_SIZE))};
-        if (0 <= chunk_loc.x && chunk_loc.x < CST::LEVEL_WIDTH && 0 <= chunk_loc.y && chunk_loc.y < CST::LEVEL_HEIGHT)
+        const LevelFile::PackedTile& packed {tiles[t]};
+        const int localX {packed.x - origin.x};
+        const int localY {packed.y - origin.y};
+        // CompiledLevel::validate already rejects these, but a stray one must never index past the grid
+        if (localX < 0 || localX >= CST::CHUNK_SIZE || localY < 0 || localY >= CST::CHUNK_SIZE)
+        {
+            continue;
+        }
+        const int cell {localY * CST::CHUNK_SIZE + localX};
+        // first tile wins if the map has duplicates
+        if (chunk->grid[cell] != 0)
+        {
+            continue;
+        }
+        chunk->tiles.push_back(Tile{{packed.x, packed.y}, getTileType(packed.type), packed.variant});
+        chunk->grid[cell] = static_cast<std::uint16_t>(chunk->tiles.size());
+        if (Util::elementIn<TileType, std::size(SOLID_TILES)>(chunk->tiles.back().type, SOLID_TILES.data()))
         {
-            // calc chunk index
-            int chunk_idx {chunk_loc.y * CST::LEVEL_WIDTH + chunk_loc.x};
-            Chunk* chunk {&(m_chunks[chunk_idx])};
-            chunk->tiles.push_back(Tile{{tile["pos"][0], tile["pos"][1]}, getTileType(tile["type"]), tile["variant"]});
-            chunk->pos = chunk_loc;
+            chunk->solid |= std::uint64_t{1} << cell;
         }
     }
 
     // handle decor (offgrid tiles)
-    for (const auto& tile : data["level"]["off_grid"])
+    chunk->decor.reserve(entry->numDecor);
+    for (std::uint32_t d{entry->firstDecor}; d < entry->firstDecor + entry->numDecor; ++d)
+    {
+        chunk->decor.push_back(Decor{{decor[d].x, decor[d].y}, getDecorType(decor[d].type), decor[d].variant});
+    }
+    return chunk;
+}
+
+void World::insertChunk(Chunk* chunk)
+{
+    if (chunk == nullptr)
+    {
+        return;
+    }
+    const std::uint64_t key {Util::chunkKey(chunk->pos.x, chunk->pos.y)};
+    // the streaming thread can finish a chunk that was already loaded because it came on screen,
+    // or one that has since been edited and stashed
+    if (m_chunks.count(key) > 0 || restoreChunk(key))
     {
-        vec2<int> chunk_loc {static_cast<int>(std::floor((float)tile["pos"][0] / (float)CST::TILE_SIZE / (float)CST::CHUNK_SIZE)), static_cast<int>(std::floor((float)tile["pos"][1] / (float)CST::TILE_SIZE / (float)CST::CHUNK_SIZE))};
-        if (0 <= chunk_loc.x && chunk_loc.x < CST::LEVEL_WIDTH && 0 <= chunk_loc.y && chunk_loc.y < CST::LEVEL_HEIGHT)
+        delete chunk;
+        return;
+    }
+    m_chunks.emplace(key, chunk);
+    invalidateChunk(chunk->pos.x, chunk->pos.y);
+}
+
+bool World::restoreChunk(const std::uint64_t key)
+{
+    const auto it {m_stash.find(key)};
+    if (it == m_stash.end())
+    {
+        return false;
+    }
+    const ChunkEdits& edits {it->second};
+
+    // decor comes from the level file, the tiles are replaced with the edited ones
+    Chunk* chunk {buildChunk(edits.pos.x, edits.pos.y)};
+    if (chunk == nullptr)
+    {
+        chunk = new Chunk{edits.pos};
+    }
+    chunk->tiles.clear();
+    chunk->grid.fill(0);
+    chunk->solid = 0;
+    for (int cell{0}; cell < ChunkEdits::CELLS; ++cell)
+    {
+        if (edits.type[cell] < 0)
         {
-            // calc chunk index
-            int chunk_idx {chunk_loc.y * CST::LEVEL_WIDTH + chunk_loc.x};
-            DecorChunk* chunk {&(m_decorChunks[chunk_idx])};
-            chunk->decor.push_back(Decor{{tile["pos"][0], tile["pos"][1]}, getDecorType(tile["type"]), tile["variant"]});
-            chunk->pos = chunk_loc;
+            continue;
         }
+        const vec2<int> pos {edits.pos.x * CST::CHUNK_SIZE + cell % CST::CHUNK_SIZE, edits.pos.y * CST::CHUNK_SIZE + cell / CST::CHUNK_SIZE};
+        chunk->tiles.push_back(Tile{pos, static_cast<TileType>(edits.type[cell]), edits.variant[cell], edits.health[cell]});
+        chunk->grid[cell] = static_cast<std::uint16_t>(chunk->tiles.size());
+        if (Util::elementIn<TileType, std::size(SOLID_TILES)>(chunk->tiles.back().type, SOLID_TILES.data()))
+        {
+            chunk->solid |= std::uint64_t{1} << cell;
+        }
+    }
+    chunk->edited = true;
+
+    m_stash.erase(it);
+    m_chunks.emplace(key, chunk);
+    invalidateChunk(chunk->pos.x, chunk->pos.y);
+    return true;
+}
+
+void World::evictChunk(const std::uint64_t key)
+{
+    const auto it {m_chunks.find(key)};
+    if (it == m_chunks.end())
+    {
+        return;
+    }
+    Chunk* chunk {it->second};
+    m_chunks.erase(it);
+    if (chunk->cache.id > 0)
+    {
+        UnloadRenderTexture(chunk->cache);
+        chunk->cache = RenderTexture2D{};
+    }
+    chunk->cacheDirty = false;
+    // a stale key in m_dirtyChunks is skipped by updateRenderCache
+
+    // the level file doesn't have the edits, so keep the tiles around
+    if (chunk->edited)
+    {
+        ChunkEdits edits{};
+        edits.pos = chunk->pos;
+        edits.type.fill(-1);
+        for (int cell{0}; cell < ChunkEdits::CELLS; ++cell)
+        {
+            const std::uint16_t idx {chunk->grid[cell]};
+            if (idx == 0)
+            {
+                continue;
+            }
+            const Tile& tile {chunk->tiles[idx - 1]};
+            edits.type[cell] = static_cast<std::int8_t>(tile.type);
+            edits.variant[cell] = static_cast<std::uint8_t>(tile.variant);
+            edits.health[cell] = tile.health;
+        }
+        m_stash.insert_or_assign(key, edits);
+    }
+    delete chunk;
+}
+
+Chunk* World::getEditableChunk(const int chunkX, const int chunkY)
+{
+    const std::uint64_t key {Util::chunkKey(chunkX, chunkY)};
+    auto it {m_chunks.find(key)};
+    if (it != m_chunks.end())
+    {
+        return it->second;
+    }
+    if (!restoreChunk(key))
+    {
+        // nothing in the level file means an empty chunk we're about to build on
+        Chunk* chunk {buildChunk(chunkX, chunkY)};
+        insertChunk(chunk != nullptr ? chunk : new Chunk{{chunkX, chunkY}});
+    }
+    return m_chunks[key];
+}
+
+void World::setSolid(const int tileX, const int tileY, const bool solid)
+{
+    std::uint64_t& word {m_solid[static_cast<std::size_t>(tileY) * m_solidStride + (tileX >> 6)]};
+    const std::uint64_t bit {std::uint64_t{1} << (tileX & 63)};
+    word = solid ? (word | bit) : (word & ~bit);
+}
+
+void World::autotileAround(const int tileX, const int tileY)
+{
+    // neighbour mask (left, up, right, down) -> variant, same rules as the level editor
+    constexpr std::array<int, 16> variants {15, 3, 12, 0, 11, 7, 8, 4, 14, 2, 13, 1, 10, 6, 9, 5};
+    constexpr std::array<vec2<int>, 5> offsets {vec2<int>{0, 0}, vec2<int>{-1, 0}, vec2<int>{1, 0}, vec2<int>{0, -1}, vec2<int>{0, 1}};
+
+    for (const vec2<int>& offset : offsets)
+    {
+        const int x {tileX + offset.x};
+        const int y {tileY + offset.y};
+        // only solid tiles are autotiled
+        if (!isSolid(x, y))
+        {
+            continue;
+        }
+        const int mask {isSolid(x - 1, y) << 3 | isSolid(x, y - 1) << 2 | isSolid(x + 1, y) << 1 | static_cast<int>(isSolid(x, y + 1))};
+        Chunk* chunk {getEditableChunk(Util::floorDiv(x, CST::CHUNK_SIZE), Util::floorDiv(y, CST::CHUNK_SIZE))};
+        Tile* tile {getTile(x, y)};
+        if (tile != nullptr && tile->variant != variants[mask])
+        {
+            tile->variant = variants[mask];
+            chunk->edited = true;
+            invalidateChunk(chunk->pos.x, chunk->pos.y);
+        }
+    }
+}
+
+bool World::removeTile(const int tileX, const int tileY)
+{
+    if (!(0 <= tileX && tileX < m_widthTiles && 0 <= tileY && tileY < m_heightTiles))
+    {
+        return false;
+    }
+
+    Chunk* chunk {getEditableChunk(Util::floorDiv(tileX, CST::CHUNK_SIZE), Util::floorDiv(tileY, CST::CHUNK_SIZE))};
+    const int cell {(tileY - chunk->pos.y * CST::CHUNK_SIZE) * CST::CHUNK_SIZE + (tileX - chunk->pos.x * CST::CHUNK_SIZE)};
+    const std::uint16_t idx {chunk->grid[cell]};
+    if (idx == 0)
+    {
+        return false;
+    }
+
+    // swap and pop keeps `tiles` packed, then point the moved tile's grid cell at its new slot
+    if (idx != chunk->tiles.size())
+    {
+        Tile& moved {chunk->tiles[idx - 1]};
+        moved = chunk->tiles.back();
+        chunk->grid[(moved.pos.y - chunk->pos.y * CST::CHUNK_SIZE) * CST::CHUNK_SIZE + (moved.pos.x - chunk->pos.x * CST::CHUNK_SIZE)] = idx;
+    }
+    chunk->tiles.pop_back();
+    chunk->grid[cell] = 0;
+    chunk->solid &= ~(std::uint64_t{1} << cell);
+    chunk->edited = true;
+    setSolid(tileX, tileY, false);
+    ++m_revision;
+    invalidateChunk(chunk->pos.x, chunk->pos.y);
+
+    autotileAround(tileX, tileY);
+    return true;
+}
+
+bool World::placeTile(const int tileX, const int tileY, const TileType type)
+{
+    if (type == TileType::NONE || !(0 <= tileX && tileX < m_widthTiles && 0 <= tileY && tileY < m_heightTiles))
+    {
+        return false;
+    }
+
+    Chunk* chunk {getEditableChunk(Util::floorDiv(tileX, CST::CHUNK_SIZE), Util::floorDiv(tileY, CST::CHUNK_SIZE))};
+    const int cell {(tileY - chunk->pos.y * CST::CHUNK_SIZE) * CST::CHUNK_SIZE + (tileX - chunk->pos.x * CST::CHUNK_SIZE)};
+    if (chunk->grid[cell] != 0)
+    {
+        return false;
+    }
+
+    chunk->tiles.push_back(Tile{{tileX, tileY}, type, 0});
+    chunk->grid[cell] = static_cast<std::uint16_t>(chunk->tiles.size());
+    const bool solid {Util::elementIn<TileType, std::size(SOLID_TILES)>(type, SOLID_TILES.data())};
+    if (solid)
+    {
+        chunk->solid |= std::uint64_t{1} << cell;
+    }
+    chunk->edited = true;
+    setSolid(tileX, tileY, solid);
+    ++m_revision;
+    invalidateChunk(chunk->pos.x, chunk->pos.y);
+
+    // picks the new tile's variant too
+    autotileAround(tileX, tileY);
+    return true;
+}
+
+int World::damageTilesInRadius(const vec2<float>& center, const float radius, const float damage)
+{
+    // collect first, removing tiles changes the bitmap we're scanning
+    m_editQueue.clear();
+    forEachSolidTile({center.x - radius, center.y - radius, radius * 2.f, radius * 2.f}, [&](const Rectangle& rect) {
+        const float dx {rect.x + rect.width * 0.5f - center.x};
+        const float dy {rect.y + rect.height * 0.5f - center.y};
+        if (dx * dx + dy * dy <= radius * radius)
+        {
+            m_editQueue.push_back({static_cast<int>(rect.x) / CST::TILE_SIZE, static_cast<int>(rect.y) / CST::TILE_SIZE});
+        }
+    });
+
+    int broken {0};
+    for (const vec2<int>& pos : m_editQueue)
+    {
+        Chunk* chunk {getEditableChunk(Util::floorDiv(pos.x, CST::CHUNK_SIZE), Util::floorDiv(pos.y, CST::CHUNK_SIZE))};
+        Tile* tile {getTile(pos.x, pos.y)};
+        if (tile == nullptr)
+        {
+            continue;
+        }
+        tile->health -= damage;
+        chunk->edited = true;
+        if (tile->health <= 0.f)
+        {
+            broken += removeTile(pos.x, pos.y);
+        }
+    }
+    return broken;
+}
+
+int World::removeTilesInRadius(const vec2<float>& center, const float radius)
+{
+    return damageTilesInRadius(center, radius, std::numeric_limits<float>::infinity());
+}
+
+void World::updateRenderCache(AssetManager* assets)
+{
+    for (const std::uint64_t key : m_dirtyChunks)
+    {
+        const auto it {m_chunks.find(key)};
+        if (it != m_chunks.end())
+        {
+            bakeChunk(it->second, assets);
+        }
+    }
+    m_dirtyChunks.clear();
+}
+
+void World::bakeChunk(Chunk* chunk, AssetManager* assets)
+{
+    chunk->cacheDirty = false;
+
+    if (chunk->tiles.empty() && chunk->decor.empty())
+    {
+        if (chunk->cache.id > 0)
+        {
+            UnloadRenderTexture(chunk->cache);
+            chunk->cache = RenderTexture2D{};
+        }
+        return;
     }
 
-    // load colliders
-    for (std::size_t i{0}; i < CST::NUM_CHUNKS; ++i)
+    if (chunk->cache.id == 0)
+    {
+        constexpr int size {CST::CHUNK_SIZE * CST::TILE_SIZE + DECOR_SIZE};
+        chunk->cache = LoadRenderTexture(size, size);
+    }
+
+    // draw relative to the chunk's top left corner
+    const vec2<int> origin {chunk->pos.x * CST::CHUNK_SIZE * CST::TILE_SIZE, chunk->pos.y * CST::CHUNK_SIZE * CST::TILE_SIZE};
+    BeginTextureMode(chunk->cache);
+    ClearBackground(BLANK);
+    renderDecorChunk(chunk, origin, assets);
+    renderChunk(chunk, origin, assets);
+    EndTextureMode();
+}
+
+void World::invalidateChunk(const int chunkX, const int chunkY)
+{
+    // chunks that aren't resident get baked when they're streamed in
+    const std::uint64_t key {Util::chunkKey(chunkX, chunkY)};
+    const auto it {m_chunks.find(key)};
+    if (it != m_chunks.end() && !it->second->cacheDirty)
+    {
+        it->second->cacheDirty = true;
+        m_dirtyChunks.push_back(key);
+    }
+}
+
+void World::free()
+{
+    for (auto& [key, chunk] : m_chunks)
     {
-        Chunk* chunk {&m_chunks[i]};
-        for (std::size_t t{0}; t < chunk->tiles.size(); ++t)
+        if (chunk->cache.id > 0)
         {
-            std::string key {std::to_string(chunk->tiles[t].pos.x) + ";" + std::to_string(chunk->tiles[t].pos.y)};
-            chunk->colliders.insert(std::pair<std::string, Tile*>(key, &chunk->tiles[t]));
+            UnloadRenderTexture(chunk->cache);
         }
+        delete chunk;
     }
+    m_chunks.clear();
+    m_dirtyChunks.clear();
+    // edits go with the chunks
+    m_stash.clear();
+}
+
+void World::loadFromFile(const char* path)
+{
+    // prefer the compiled level next to the json, it's mmap'ed and needs no parsing
+    if (!loadCompiled(LevelFile::compiledPath(path).c_str()))
+    {
+        loadJson(path);
+    }
+}
+
+bool World::loadCompiled(const char* path)
+{
+    const std::chrono::steady_clock::time_point start {std::chrono::steady_clock::now()};
+
+    CompiledLevel level{};
+    if (!level.open(path))
+    {
+        return false;
+    }
+    // the mapping is kept open, chunks are paged in from it as the camera moves
+    loadLevel(level);
+
+    const std::chrono::duration<double, std::milli> elapsed {std::chrono::steady_clock::now() - start};
+    std::cout << "Loaded compiled level from `" << path << "` in " << elapsed.count() << "ms!\n";
+    return true;
+}
+
+bool World::loadJson(const char* path)
+{
+    const std::chrono::steady_clock::time_point start {std::chrono::steady_clock::now()};
 
+    std::ifstream f;
+    f.open(path);
+    if (!f.is_open())
+    {
+        std::cout << "Failed to read from `" << path << "`!\n";
+        return false;
+    }
+    json data = json::parse(f);
     f.close();
+    std::cout << "Parsed json from `" << path << "`!\n";
+
+    // compile it in memory so both paths share the same loader
+    CompiledLevel level{};
+    if (!level.open(LevelFile::compile(data)))
+    {
+        std::cout << "ERROR: Failed to compile level `" << path << "`!\n";
+        return false;
+    }
+    loadLevel(level);
+
+    const std::chrono::duration<double, std::milli> elapsed {std::chrono::steady_clock::now() - start};
+    std::cout << "Loaded level from `" << path << "` in " << elapsed.count() << "ms!\n";
+    return true;
+}
+
+void World::loadLevel(CompiledLevel& level)
+{
+    m_streamer.stop();
+    free();
+
+    m_level.swap(level);
+    m_widthChunks = std::max(0, m_level.getHeader().widthChunks);
+    m_heightChunks = std::max(0, m_level.getHeader().heightChunks);
+    buildSolidBitmap();
+    ++m_revision;
+
+    // nothing is resident yet, the first stream() loads what's on screen
+    m_streamer.start([this](const int chunkX, const int chunkY) {
+        return buildChunk(chunkX, chunkY);
+    });
 }
@@ -8,11 +8,16 @@ using json = nlohmann::json;
 #include "vec2.hpp"
 #include "constants.hpp"
 #include "assets.hpp"
+#include "levelfile.hpp"
+#include "streamer.hpp"
 #include "raylib.h"
 
 #include <vector>
+#include <unordered_map>
 #include <array>
-#include <map>
+#include <cstdint>
+#include <cmath>
+#include <algorithm>
 
 enum class TileType
 {
@@ -29,11 +34,18 @@ enum class DecorType
 
 constexpr std::array<TileType, 2> SOLID_TILES {TileType::GRASS, TileType::SAND};
 
+// decor sprites are 32x32 and can hang over the edge of their chunk
+constexpr int DECOR_SIZE {32};
+
+// damage a tile takes before it breaks (see World::damageTilesInRadius)
+constexpr float TILE_HEALTH {20.f};
+
 struct Tile
 {
     vec2<int> pos; // relative pos
     TileType type;
     int variant;
+    float health{TILE_HEALTH};
 };
 
 struct Decor
@@ -43,34 +55,91 @@ struct Decor
     int variant;
 };
 
+// the solid mask stores one bit per grid cell
+static_assert(CST::CHUNK_SIZE * CST::CHUNK_SIZE <= 64, "chunk grid doesn't fit in the solid mask");
+
 struct Chunk
 {
     vec2<int> pos; // relative pos
     std::vector<Tile> tiles{};
-    std::map<std::string, Tile*> colliders{};
+    // dense CHUNK_SIZE * CHUNK_SIZE grid (row major) of indices into `tiles`, 0 = empty, otherwise index + 1
+    std::array<std::uint16_t, CST::CHUNK_SIZE * CST::CHUNK_SIZE> grid{};
+    std::uint64_t solid{0}; // bit set = solid tile in that grid cell
+    std::vector<Decor> decor{};
+
+    // decor + tiles baked into one texture (see World::updateRenderCache), padded by DECOR_SIZE for overhanging decor
+    RenderTexture2D cache{};
+    bool cacheDirty{false};
+    // tiles differ from the level file, the chunk gets stashed instead of dropped when it's evicted
+    bool edited{false};
 };
 
-struct DecorChunk
+// all an evicted edited chunk keeps: one fixed size record of its grid cells, no heap memory and no decor
+// (decor is never edited, it comes back from the level file)
+struct ChunkEdits
 {
-    vec2<int> pos;
-    std::vector<Decor> decor{};
+    static constexpr int CELLS {CST::CHUNK_SIZE * CST::CHUNK_SIZE};
+
+    vec2<int> pos{};
+    std::array<std::int8_t, CELLS> type{}; // TileType, -1 for an empty cell
+    std::array<std::uint8_t, CELLS> variant{};
+    std::array<float, CELLS> health{};
+};
+
+struct RayHit
+{
+    bool hit{false};
+    vec2<float> pos{}; // where the ray entered the solid tile
+    vec2<int> tile{};
+    vec2<int> normal{}; // face of the tile that was hit, {0, 0} if the ray started inside it
+    float distance{0.0f};
+};
+
+// inclusive range of chunk coords, empty if x0 > x1 or y0 > y1
+struct ChunkRange
+{
+    int x0;
+    int y0;
+    int x1;
+    int y1;
 };
 
 class World
 {
 public:
     World() = default;
-    ~World() = default;
+    ~World();
+
+    World(const World&) = delete;
+    World& operator=(const World&) = delete;
 
+    // resident chunk at a pixel position, nullptr if it's empty or not streamed in
     Chunk* getChunkAt(const float x, const float y);
 
     Tile* getTileAt(const float x, const float y);
+    // same as getTileAt, but takes tile coords
+    Tile* getTile(int tileX, int tileY);
+
+    // solid bitmap lookups, these cover the whole level whether the chunks are resident or not
+    // (tiles outside the level are never solid)
+    [[nodiscard]] bool isSolid(int tileX, int tileY) const;
+    [[nodiscard]] bool isSolidAt(float x, float y) const;
+    // isSolidAt for a batch of points, writes the index of every solid one to hits (room for count)
+    // and returns how many there were
+    std::size_t findSolid(const float* xs, const float* ys, std::size_t count, std::uint32_t* hits) const;
+
+    // first solid tile along the ray (Amanatides-Woo grid traversal over the solid bitmap), dir doesn't have to be normalized
+    [[nodiscard]] RayHit raycast(const vec2<float>& origin, const vec2<float>& dir, float maxDist) const;
+    // true if there's no solid tile between a and b
+    [[nodiscard]] bool lineOfSight(const vec2<float>& a, const vec2<float>& b) const;
 
-    void getTilesAroundPos(const vec2<float>& pos, std::array<Rectangle, 9>& rects);
+    // calls fn(const Rectangle& tileRect) for every solid tile overlapping rect (any size)
+    template <typename F>
+    void forEachSolidTile(const Rectangle& rect, F&& fn) const;
 
-    TileType getTileType(int type);
+    TileType getTileType(int type) const;
 
-    DecorType getDecorType(int type);
+    DecorType getDecorType(int type) const;
 
     Texture2D* getTileTex(const Tile& tile, AssetManager* assets) const;
     Texture2D* getDecorTex(const Decor& tile, AssetManager* assets) const;
@@ -80,15 +149,134 @@ public:
     Rectangle getDecorClipRect(const Decor& tile) const;
 
     void renderChunk(Chunk* chunk, const vec2<int>& scroll, AssetManager* assets);
-    void renderDecorChunk(DecorChunk* chunk, const vec2<int>& scroll, AssetManager* assets);
+    void renderDecorChunk(Chunk* chunk, const vec2<int>& scroll, AssetManager* assets);
 
-    void render(const vec2<int>& scroll, int width, int height, AssetManager* assets);
+    // chunks overlapping rect (world pixels), clamped to the level
+    [[nodiscard]] ChunkRange getChunksInRect(const Rectangle& rect) const;
 
+    // draw the chunks visible in the camera rect (see Util::getViewRect)
+    void render(const Rectangle& view);
+
+    // page chunks in and out around the camera rect, call once per frame before updateRenderCache
+    // visible chunks are loaded right away, the STREAM_MARGIN rings around them on the streaming thread while there's budget
+    void stream(const Rectangle& view);
+    // max resident chunks, visible chunks are never evicted so it can be exceeded on huge screens
+    void setChunkBudget(int budget) {m_chunkBudget = budget;}
+    [[nodiscard]] std::size_t getResidentChunks() const {return m_chunks.size();}
+
+    // level bounds, taken from the compiled level
+    [[nodiscard]] int getWidthChunks() const {return m_widthChunks;}
+    [[nodiscard]] int getHeightChunks() const {return m_heightChunks;}
+    [[nodiscard]] float getPixelWidth() const {return static_cast<float>(m_widthChunks * CST::CHUNK_SIZE * CST::TILE_SIZE);}
+    [[nodiscard]] float getPixelHeight() const {return static_cast<float>(m_heightChunks * CST::CHUNK_SIZE * CST::TILE_SIZE);}
+
+    // bake dirty chunks into their render textures, must be called outside of BeginTextureMode
+    void updateRenderCache(AssetManager* assets);
+    // mark a chunk's render cache as stale, it gets rebaked on the next updateRenderCache
+    void invalidateChunk(int chunkX, int chunkY);
+    // unload the chunk render textures and drop every resident and stashed chunk, edits included (needs the window to still be open)
+    void free();
+
+    // terrain editing (tile coords), only inside the level bounds
+    // each edit updates the chunk grid + solid mask, the solid bitmap and the autotile variants around it,
+    // and marks the touched chunks for a rebake
+    bool removeTile(int tileX, int tileY);
+    bool placeTile(int tileX, int tileY, TileType type);
+    // hurt every solid tile with its centre in the circle, returns how many broke
+    int damageTilesInRadius(const vec2<float>& center, float radius, float damage);
+    int removeTilesInRadius(const vec2<float>& center, float radius);
+    // bumped whenever the solid tiles change (edits, loading), lets cached data know when to rebuild
+    [[nodiscard]] std::uint32_t getRevision() const {return m_revision;}
+
+    // loads the compiled level (.lvl) next to path if there is one, otherwise parses the json
     void loadFromFile(const char* path);
+    bool loadCompiled(const char* path);
+    bool loadJson(const char* path);
 
 private:
-    Chunk m_chunks[CST::NUM_CHUNKS];
-    DecorChunk m_decorChunks[CST::NUM_CHUNKS];
+    Chunk* getChunkAtTile(int tileX, int tileY);
+
+    // take over the compiled level as the chunk backing store
+    void loadLevel(CompiledLevel& level);
+
+    // level entry for a chunk, nullptr if the chunk is empty
+    [[nodiscard]] const LevelFile::ChunkEntry* findEntry(int chunkX, int chunkY) const;
+    // decode a chunk from the level, safe to call from the streaming thread
+    [[nodiscard]] Chunk* buildChunk(int chunkX, int chunkY) const;
+    // make a chunk resident (deletes it if the chunk already is, or if there's an edited copy in the stash)
+    void insertChunk(Chunk* chunk);
+    // rebuild a stashed chunk from the level file + its edits and make it resident, false if there isn't one
+    bool restoreChunk(std::uint64_t key);
+    void evictChunk(std::uint64_t key);
+    // resident chunk for an edit, loading (or creating) it if needed
+    Chunk* getEditableChunk(int chunkX, int chunkY);
+
+    void setSolid(int tileX, int tileY, bool solid);
+    // recompute the variant of the tile at tileX, tileY and its 4 neighbours
+    void autotileAround(int tileX, int tileY);
+
+    void bakeChunk(Chunk* chunk, AssetManager* assets);
+
+    // build m_solid from every tile in the level
+    void buildSolidBitmap();
+
+    CompiledLevel m_level{};
+    ChunkStreamer m_streamer{};
+    int m_widthChunks{0};
+    int m_heightChunks{0};
+    int m_chunkBudget{CST::CHUNK_BUDGET};
+    std::uint32_t m_revision{0};
+
+    // resident chunks keyed by Util::chunkKey
+    std::unordered_map<std::uint64_t, Chunk*> m_chunks{};
+    // keys of chunks waiting to be (re)baked
+    std::vector<std::uint64_t> m_dirtyChunks{};
+    // edits of chunks that were evicted. resident memory is bounded by the CHUNK_BUDGET full chunks plus one
+    // sizeof(ChunkEdits) (~400 bytes) per chunk ever edited, so at worst one record per chunk of the level,
+    // the same order as the solid bitmap. the edits can't be dropped, the solid bitmap already has them
+    std::unordered_map<std::uint64_t, ChunkEdits> m_stash{};
+    // tiles hit by the current damageTilesInRadius call
+    std::vector<vec2<int>> m_editQueue{};
+
+    // level wide solid bitmap, one bit per tile, each row padded to whole 64 bit words
+    std::vector<std::uint64_t> m_solid{};
+    int m_solidStride{0}; // words per row
+    int m_widthTiles{0};
+    int m_heightTiles{0};
 };
 
+template <typename F>
+void World::forEachSolidTile(const Rectangle& rect, F&& fn) const
+{
+    // tiles touched by the rect, edges are exclusive like CheckCollisionRecs
+    const int x0 {std::max(0, static_cast<int>(std::floor(rect.x / (float)CST::TILE_SIZE)))};
+    const int y0 {std::max(0, static_cast<int>(std::floor(rect.y / (float)CST::TILE_SIZE)))};
+    const int x1 {std::min(m_widthTiles - 1, static_cast<int>(std::ceil((rect.x + rect.width) / (float)CST::TILE_SIZE)) - 1)};
+    const int y1 {std::min(m_heightTiles - 1, static_cast<int>(std::ceil((rect.y + rect.height) / (float)CST::TILE_SIZE)) - 1)};
+    if (x0 > x1 || y0 > y1)
+    {
+        return;
+    }
+
+    for (int y{y0}; y <= y1; ++y)
+    {
+        const std::uint64_t* row {m_solid.data() + static_cast<std::size_t>(y) * m_solidStride};
+        // scan a whole word at a time, masking off the columns outside the rect
+        for (int w{x0 >> 6}; w <= (x1 >> 6); ++w)
+        {
+            std::uint64_t bits {row[w]};
+            const int lo {std::max(x0 - (w << 6), 0)};
+            const int hi {std::min(x1 - (w << 6), 63)};
+            bits &= ~std::uint64_t{0} << lo;
+            bits &= ~std::uint64_t{0} >> (63 - hi);
+            while (bits != 0)
+            {
+                const int x {(w << 6) + __builtin_ctzll(bits)};
+                bits &= bits - 1;
+                fn(Rectangle{static_cast<float>(x * CST::TILE_SIZE), static_cast<float>(y * CST::TILE_SIZE), CST::TILE_SIZE, CST::TILE_SIZE});
+            }
+        }
+    }
+}
+
 #endif
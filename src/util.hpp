@@ -4,10 +4,12 @@
 #include <vector>
 #include <cstdlib>
 #include <cmath>
+#include <cstdint>
 
 #include <raylib.h>
 
 #include "./vec2.hpp"
+#include "./constants.hpp"
 
 namespace Util {
     template <typename T, int N>
@@ -29,11 +31,43 @@ namespace Util {
         return arr[static_cast<std::size_t>(std::rand() % N)];
     }
 
+    // camera rect in world pixels (at the virtual resolution), shared by everything that culls against the screen
+    inline Rectangle getViewRect(const vec2<int>& scroll, const int width, const int height)
+    {
+        return Rectangle{static_cast<float>(scroll.x), static_cast<float>(scroll.y), static_cast<float>(width) / CST::SCR_VRATIO, static_cast<float>(height) / CST::SCR_VRATIO};
+    }
+
+    inline bool inView(const Rectangle& view, const Rectangle& rect)
+    {
+        return CheckCollisionRecs(view, rect);
+    }
+
+    // integer division that rounds towards negative infinity
+    inline int floorDiv(const int a, const int b)
+    {
+        return (a >= 0 ? a : a - b + 1) / b;
+    }
+
+    // pack chunk coords into one hash key
+    inline std::uint64_t chunkKey(const int chunkX, const int chunkY)
+    {
+        return (static_cast<std::uint64_t>(static_cast<std::uint32_t>(chunkX)) << 32) | static_cast<std::uint32_t>(chunkY);
+    }
+
     inline float random()
     {
         return static_cast<float>((float)std::rand() / (RAND_MAX));
     }
 
+    // xorshift on a caller owned state (never 0), for code that can't share rand() across threads
+    inline float random(std::uint32_t& state)
+    {
+        state ^= state << 13;
+        state ^= state >> 17;
+        state ^= state << 5;
+        return static_cast<float>(state >> 8) / 16777216.f;
+    }
+
     template <typename T>
     inline float distance(vec2<T> vec1, vec2<T> vec2)
     {
@@ -48,6 +82,26 @@ namespace Util {
         *val2 = temp;
     }
 
+    // parallel arrays (one per field) that grow and shrink together
+    template <typename... Arrays>
+    inline void reserveAll(const std::size_t capacity, Arrays&... arrays)
+    {
+        (arrays.reserve(capacity), ...);
+    }
+
+    // move the last element of every array into i and drop the last, order isn't kept
+    template <typename... Arrays>
+    inline void swapRemove(const std::size_t i, Arrays&... arrays)
+    {
+        ((arrays[i] = arrays.back(), arrays.pop_back()), ...);
+    }
+
+    template <typename... Arrays>
+    inline void clearAll(Arrays&... arrays)
+    {
+        (arrays.clear(), ...);
+    }
+
     template <typename type>
     std::vector<int> get_water_indices(std::vector<type> vertices)
     {
@@ -0,0 +1,276 @@
+#include "waves.hpp"
+#include "entities.hpp"
+#include "constants.hpp"
+#include "util.hpp"
+
+#include <JSON/json.hpp>
+
+#include <fstream>
+#include <iostream>
+#include <algorithm>
+#include <type_traits>
+#include <vector>
+
+using json = nlohmann::json;
+
+namespace
+{
+    // the cap never goes below this, however slow the frame
+    constexpr float MIN_CAP {16.f};
+
+    // a number that fits T, a wrongly typed one falls back like a missing one (but with a warning)
+    template <typename T>
+    T readNumber(const json& data, const char* key, const T fallback)
+    {
+        if (!data.contains(key))
+        {
+            return fallback;
+        }
+        const json& value {data[key]};
+        if constexpr (std::is_floating_point_v<T>)
+        {
+            if (value.is_number())
+            {
+                return value.get<T>();
+            }
+        } else if (std::is_signed_v<T> ? value.is_number_integer() : value.is_number_unsigned())
+        {
+            return value.get<T>();
+        }
+        std::cout << "WARNING: `" << key << "` should be a " << (std::is_floating_point_v<T> ? "number" : "whole number") << "!\n";
+        return fallback;
+    }
+
+    // [start, end] or a single number for both
+    vec2<float> readRange(const json& data, const char* key, const vec2<float>& fallback)
+    {
+        if (!data.contains(key))
+        {
+            return fallback;
+        }
+        const json& value {data[key]};
+        if (value.is_array() && value.size() == 2 && value[0].is_number() && value[1].is_number())
+        {
+            return {value[0].get<float>(), value[1].get<float>()};
+        }
+        if (value.is_number())
+        {
+            return {value.get<float>(), value.get<float>()};
+        }
+        std::cout << "WARNING: `" << key << "` should be a number or [start, end]!\n";
+        return fallback;
+    }
+
+    float lerp(const vec2<float>& range, const float t)
+    {
+        return range.x + (range.y - range.x) * t;
+    }
+}
+
+bool WaveDirector::loadFromFile(const char* path)
+{
+    reset();
+
+    std::ifstream f;
+    f.open(path);
+    if (!f.is_open())
+    {
+        std::cout << "Failed to read waves from `" << path << "`!\n";
+        return false;
+    }
+    const json data = json::parse(f, nullptr, false);
+    f.close();
+    if (data.is_discarded() || !data.is_object())
+    {
+        std::cout << "ERROR: Failed to parse waves from `" << path << "`!\n";
+        return false;
+    }
+
+    // the pools can't hold more than this anyway
+    constexpr std::size_t poolLimit {static_cast<std::size_t>(CST::MAX_ENEMIES) * NUM_ENEMY_TYPES};
+    m_maxEnemies = std::min(readNumber(data, "maxEnemies", m_maxEnemies), poolLimit);
+    m_frameBudget = readNumber(data, "frameBudget", m_frameBudget);
+    m_stragglerDistance = readNumber(data, "stragglerDistance", m_stragglerDistance);
+
+    // entries that aren't objects are skipped, the defaults stay if none are left
+    std::vector<SpawnPoint> spawnPoints{};
+    if (data.contains("spawnPoints") && data["spawnPoints"].is_array())
+    {
+        for (const json& point : data["spawnPoints"])
+        {
+            if (!point.is_object())
+            {
+                std::cout << "WARNING: Spawn point in `" << path << "` isn't an object!\n";
+                continue;
+            }
+            spawnPoints.push_back(SpawnPoint{{readNumber(point, "x", 0.f), readNumber(point, "y", -10.f)}, readNumber(point, "dir", 1.f) < 0.f ? -1.f : 1.f});
+        }
+    }
+    if (!spawnPoints.empty())
+    {
+        m_spawnPoints = spawnPoints;
+    }
+
+    std::vector<EnemyWave> waves{};
+    if (data.contains("waves") && data["waves"].is_array())
+    {
+        for (const json& entry : data["waves"])
+        {
+            if (!entry.is_object())
+            {
+                std::cout << "WARNING: Wave in `" << path << "` isn't an object!\n";
+                continue;
+            }
+            EnemyWave wave {};
+            wave.duration = std::max(1.f, readNumber(entry, "duration", wave.duration));
+            wave.interval = readRange(entry, "interval", wave.interval);
+            wave.spread = readRange(entry, "spread", wave.spread);
+            wave.budget = readNumber(entry, "budget", wave.budget);
+            wave.maxAlive = readNumber(entry, "maxAlive", wave.maxAlive);
+            if (entry.contains("types") && entry["types"].is_object())
+            {
+                for (const auto& [name, weight] : entry["types"].items())
+                {
+                    const EnemyType type {Enemies::typeFromName(name)};
+                    if (type == EnemyType::NONE)
+                    {
+                        std::cout << "WARNING: Unknown enemy type `" << name << "` in `" << path << "`!\n";
+                        continue;
+                    }
+                    if (!weight.is_number())
+                    {
+                        std::cout << "WARNING: Weight of `" << name << "` in `" << path << "` should be a number!\n";
+                        continue;
+                    }
+                    wave.weights[static_cast<std::size_t>(type)] = std::max(0.f, weight.get<float>());
+                }
+            }
+            waves.push_back(wave);
+        }
+    }
+    if (!waves.empty())
+    {
+        m_waves = waves;
+    }
+
+    reset();
+    std::cout << "Loaded " << m_waves.size() << " waves from `" << path << "`!\n";
+    return true;
+}
+
+void WaveDirector::reset()
+{
+    m_wave = 0;
+    m_waveTime = 0.0f;
+    m_timer = 0.0f;
+    m_cap = static_cast<float>(std::min(m_maxEnemies, m_waves.front().maxAlive));
+    m_stats = WaveStats{};
+}
+
+void WaveDirector::update(const float dt, EntityManager* entities, const vec2<float>& playerCenter, const float simulateMs)
+{
+    m_stats.simulateMs += (simulateMs - m_stats.simulateMs) * std::min(1.f, 0.05f * dt);
+
+    m_waveTime += dt;
+    if (m_waveTime > m_waves[m_wave].duration && m_wave + 1 < m_waves.size())
+    {
+        ++m_wave;
+        m_waveTime = 0.0f;
+        m_stats.spawned = 0;
+    }
+    const EnemyWave& wave {m_waves[m_wave]};
+    const float t {std::min(1.f, m_waveTime / wave.duration)};
+
+    // trade population for frame time, back off fast and recover slowly
+    const float target {static_cast<float>(std::min(m_maxEnemies, wave.maxAlive))};
+    if (m_stats.simulateMs > m_frameBudget)
+    {
+        m_cap = std::max(MIN_CAP, m_cap - 0.5f * dt);
+    } else if (m_stats.simulateMs < m_frameBudget * 0.8f)
+    {
+        m_cap += 0.05f * dt;
+    }
+    m_cap = std::min(m_cap, target);
+    const std::size_t cap {static_cast<std::size_t>(m_cap)};
+
+    // over the cap (it came down, or the wave shrank), thin out whoever's far away
+    std::size_t alive {entities->getEnemyCount()};
+    if (alive > cap)
+    {
+        const std::size_t removed {entities->despawnStragglers(playerCenter, m_stragglerDistance, alive - cap)};
+        m_stats.despawned += removed;
+        alive -= removed;
+    }
+
+    m_timer += dt;
+    if (m_timer > lerp(wave.interval, t))
+    {
+        m_timer = 0.0f;
+        const float spread {lerp(wave.spread, t)};
+        for (const SpawnPoint& point : m_spawnPoints)
+        {
+            if (wave.budget >= 0 && m_stats.spawned >= static_cast<std::size_t>(wave.budget))
+            {
+                ++m_stats.skipped;
+                continue;
+            }
+            // at the cap, swap a straggler for a fresh one
+            if (alive >= cap)
+            {
+                const std::size_t removed {entities->despawnStragglers(playerCenter, m_stragglerDistance, 1)};
+                if (removed == 0)
+                {
+                    ++m_stats.skipped;
+                    continue;
+                }
+                m_stats.despawned += removed;
+                alive -= removed;
+            }
+            const EnemyHandle handle {entities->addEntity(pickType(wave), {point.pos.x + Util::random() * spread * point.dir, point.pos.y})};
+            if (handle.type == EnemyType::NONE)
+            {
+                ++m_stats.skipped;
+                continue;
+            }
+            ++m_stats.spawned;
+            ++alive;
+        }
+    }
+
+    m_stats.wave = m_wave;
+    m_stats.alive = alive;
+    m_stats.cap = cap;
+}
+
+EnemyType WaveDirector::pickType(const EnemyWave& wave) const
+{
+    float total {0.0f};
+    for (const float weight : wave.weights)
+    {
+        total += weight;
+    }
+    // no mix given, everyone's equally likely
+    if (total <= 0.0f)
+    {
+        return static_cast<EnemyType>(std::min(static_cast<std::size_t>(Util::random() * NUM_ENEMY_TYPES), NUM_ENEMY_TYPES - 1));
+    }
+
+    float pick {Util::random() * total};
+    for (std::size_t type{0}; type < NUM_ENEMY_TYPES; ++type)
+    {
+        pick -= wave.weights[type];
+        if (pick < 0.0f && wave.weights[type] > 0.0f)
+        {
+            return static_cast<EnemyType>(type);
+        }
+    }
+    // rounding, take the last type that can spawn
+    for (std::size_t type{NUM_ENEMY_TYPES}; type > 0; --type)
+    {
+        if (wave.weights[type - 1] > 0.0f)
+        {
+            return static_cast<EnemyType>(type - 1);
+        }
+    }
+    return static_cast<EnemyType>(0);
+}
@@ -0,0 +1,81 @@
+#ifndef WAVES_H
+#define WAVES_H
+
+#include "vec2.hpp"
+#include "enemies.hpp"
+
+#include <array>
+#include <vector>
+#include <cstddef>
+
+class EntityManager;
+
+// one stretch of the difficulty curve, values given as [start, end] pairs are lerped over the wave
+struct EnemyWave
+{
+    float duration{6000.f}; // frames, the last wave holds its end values once it runs out
+    vec2<float> interval{240.f, 240.f}; // frames between spawns
+    vec2<float> spread{50.f, 50.f}; // how far from a spawn point enemies can land
+    int budget{-1}; // most enemies the wave spawns, -1 for no limit
+    std::size_t maxAlive{30}; // most enemies alive at once during the wave
+    std::array<float, NUM_ENEMY_TYPES> weights{}; // chance of each type, needn't add up to 1
+};
+
+// enemies drop in at pos and up to `spread` pixels along dir
+struct SpawnPoint
+{
+    vec2<float> pos{};
+    float dir{1.f};
+};
+
+// what the director has been up to, for the debug overlay
+struct WaveStats
+{
+    std::size_t wave{0};
+    std::size_t alive{0};
+    std::size_t cap{0}; // the population the director is aiming for right now
+    std::size_t spawned{0}; // this wave
+    std::size_t despawned{0}; // this run
+    std::size_t skipped{0}; // spawns dropped at the cap or out of budget, this run
+    float simulateMs{0.0f}; // smoothed
+};
+
+// spawns enemies along the curve in data/waves.json
+//
+// the population never goes over maxEnemies or the wave's maxAlive. when a spawn is due at the cap,
+// wanderers far from the player are despawned to make room, so the fresh enemies end up where the action is.
+// the simulate time is watched too: over frameBudget the cap comes down until the frame fits, and creeps
+// back up once there's room
+class WaveDirector
+{
+public:
+    // falls back to the defaults (one endless wave) if the file can't be read
+    bool loadFromFile(const char* path);
+
+    // back to the first wave, keeps the loaded curve
+    void reset();
+
+    // simulateMs is how long the last simulate took
+    void update(float dt, EntityManager* entities, const vec2<float>& playerCenter, float simulateMs);
+
+    [[nodiscard]] const WaveStats& getStats() const {return m_stats;}
+    [[nodiscard]] std::size_t getWaveCount() const {return m_waves.size();}
+    [[nodiscard]] std::size_t getMaxEnemies() const {return m_maxEnemies;}
+
+private:
+    [[nodiscard]] EnemyType pickType(const EnemyWave& wave) const;
+
+    std::vector<EnemyWave> m_waves{EnemyWave{}};
+    std::vector<SpawnPoint> m_spawnPoints{{{10.f, -10.f}, 1.f}, {{1188.f, -10.f}, -1.f}};
+    std::size_t m_maxEnemies{250};
+    float m_frameBudget{6.f}; // ms
+    float m_stragglerDistance{480.f};
+
+    std::size_t m_wave{0};
+    float m_waveTime{0.0f};
+    float m_timer{0.0f};
+    float m_cap{0.0f};
+    WaveStats m_stats{};
+};
+
+#endif
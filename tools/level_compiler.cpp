@@ -0,0 +1,46 @@
+// builds the binary level format (src/levelfile.hpp) from an editor json map
+// usage: level_compiler <in.json> [out.lvl]
+
+#include "../src/levelfile.hpp"
+
+#include <fstream>
+#include <iostream>
+
+int main(int argc, char* argv[])
+{
+    if (argc < 2)
+    {
+        std::cout << "Usage: " << argv[0] << " <in.json> [out.lvl]\n";
+        return 1;
+    }
+
+    const std::string inPath {argv[1]};
+    const std::string outPath {argc > 2 ? argv[2] : LevelFile::compiledPath(inPath)};
+
+    std::ifstream in{inPath};
+    if (!in.is_open())
+    {
+        std::cout << "ERROR: Failed to read from `" << inPath << "`!\n";
+        return 1;
+    }
+
+    const std::vector<char> image {LevelFile::compile(nlohmann::json::parse(in))};
+    if (image.empty())
+    {
+        std::cout << "ERROR: Failed to compile `" << inPath << "`!\n";
+        return 1;
+    }
+
+    std::ofstream out{outPath, std::ios::binary};
+    if (!out.is_open())
+    {
+        std::cout << "ERROR: Failed to write to `" << outPath << "`!\n";
+        return 1;
+    }
+    out.write(image.data(), static_cast<std::streamsize>(image.size()));
+
+    const LevelFile::Header* header {reinterpret_cast<const LevelFile::Header*>(image.data())};
+    std::cout << "Compiled `" << inPath << "` -> `" << outPath << "` (" << header->numChunks << " chunks, "
+              << header->numTiles << " tiles, " << header->numDecor << " decor, " << image.size() << " bytes)\n";
+    return 0;
+}